@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#include "../source/b_tree.h"
+#include "../source/frozen_red_black_tree.h"
+#include "../source/red_black_tree.h"
+
+namespace
+{
+    using RedBlackMap = algo::RedBlackTree<std::int64_t, std::int64_t>;
+    using BTreeMap = algo::BTree<std::int64_t, std::int64_t>;
+
+    std::vector<std::int64_t> shuffled_keys(std::size_t size)
+    {
+        std::vector<std::int64_t> keys(size);
+        for(std::size_t index{0}; index < size; ++index)
+        {
+            keys[index] = static_cast<std::int64_t>(index) * 2;
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64{size});
+        return keys;
+    }
+
+    // Only the most recently built tree is kept, whatever its type, so the 100M key
+    // trees of the different benchmark families are never alive at the same time.
+    struct FilledTree
+    {
+        std::size_t size{0};
+        std::type_index type{typeid(void)};
+        std::shared_ptr<void> tree;
+    };
+
+    FilledTree filledTree;
+
+    void release_filled_tree()
+    {
+        filledTree = FilledTree{};
+    }
+
+    template<typename Tree>
+    Tree& filled_tree(std::size_t size)
+    {
+        if(filledTree.size != size
+           || filledTree.type != typeid(Tree))
+        {
+            release_filled_tree();
+            auto tree{std::make_shared<Tree>()};
+            for(const auto& key : shuffled_keys(size))
+            {
+                tree->insert(key, key);
+            }
+            filledTree = FilledTree{size, typeid(Tree), tree};
+        }
+        return *static_cast<Tree*>(filledTree.tree.get());
+    }
+
+    std::int64_t scan(const RedBlackMap& tree)
+    {
+        std::int64_t sum{0};
+        tree.for_each([&](std::int64_t, std::int64_t value)
+        {
+            sum += value;
+        });
+        return sum;
+    }
+
+    std::int64_t scan(const BTreeMap& tree)
+    {
+        std::int64_t sum{0};
+        for(auto entry{tree.begin()}; entry != tree.end(); ++entry)
+        {
+            sum += entry->second;
+        }
+        return sum;
+    }
+
+    template<typename Tree>
+    void lookup(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        Tree& tree{filled_tree<Tree>(size)};
+        std::mt19937_64 engine{42};
+        std::uniform_int_distribution<std::int64_t> keys{0, static_cast<std::int64_t>(size) * 2};
+        for(auto _ : state)
+        {
+            benchmark::DoNotOptimize(tree.find(keys(engine)));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void batched_lookup(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const RedBlackMap& tree{filled_tree<RedBlackMap>(size)};
+        std::mt19937_64 engine{42};
+        std::uniform_int_distribution<std::int64_t> keys{0, static_cast<std::int64_t>(size) * 2};
+        std::vector<std::int64_t> batch(512);
+        std::vector<RedBlackMap::iterator> found(batch.size());
+        for(auto _ : state)
+        {
+            state.PauseTiming();
+            std::generate(batch.begin(), batch.end(), [&]{ return keys(engine); });
+            state.ResumeTiming();
+            tree.find_batch(batch, found);
+            benchmark::DoNotOptimize(found.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch.size()));
+    }
+
+    void frozen_lookup(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto frozen{algo::freeze(filled_tree<RedBlackMap>(size))};
+        release_filled_tree();
+        std::mt19937_64 engine{42};
+        std::uniform_int_distribution<std::int64_t> keys{0, static_cast<std::int64_t>(size) * 2};
+        for(auto _ : state)
+        {
+            benchmark::DoNotOptimize(frozen.find(keys(engine)));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<typename Tree>
+    void insert(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto keys{shuffled_keys(size)};
+        release_filled_tree();
+        for(auto _ : state)
+        {
+            Tree tree;
+            for(const auto& key : keys)
+            {
+                tree.insert(key, key);
+            }
+            benchmark::DoNotOptimize(tree);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    template<typename Tree>
+    void ordered_scan(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        Tree& tree{filled_tree<Tree>(size)};
+        for(auto _ : state)
+        {
+            benchmark::DoNotOptimize(scan(tree));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    void sizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->Arg(1'000'000)->Arg(10'000'000)->Arg(100'000'000);
+    }
+}
+
+BENCHMARK_TEMPLATE(lookup, RedBlackMap)->Apply(sizes);
+BENCHMARK_TEMPLATE(lookup, BTreeMap)->Apply(sizes);
+BENCHMARK(batched_lookup)->Apply(sizes);
+BENCHMARK(frozen_lookup)->Apply(sizes);
+BENCHMARK_TEMPLATE(insert, RedBlackMap)->Apply(sizes)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(insert, BTreeMap)->Apply(sizes)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ordered_scan, RedBlackMap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ordered_scan, BTreeMap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
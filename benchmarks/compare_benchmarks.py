@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON reports and flags regressions.
+
+Usage: compare_benchmarks.py BASELINE CONTENDER [--threshold PERCENT] [--metric real_time|cpu_time]
+
+Files may be single reports or directories of reports, as written by the
+run_benchmarks target. Benchmarks are matched by name; when a run used
+repetitions, the mean aggregate is compared. Exits with status 1 if any
+benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import pathlib
+import sys
+
+UNIT_SCALE = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_results(path, metric):
+    path = pathlib.Path(path)
+    files = sorted(path.glob("*.json")) if path.is_dir() else [path]
+    results = {}
+    for file in files:
+        with open(file) as stream:
+            report = json.load(stream)
+        for entry in report.get("benchmarks", []):
+            if entry.get("error_occurred"):
+                continue
+            run_type = entry.get("run_type", "iteration")
+            if run_type == "aggregate" and entry.get("aggregate_name") != "mean":
+                continue
+            name = entry.get("run_name", entry["name"])
+            if run_type == "iteration" and name in results:
+                continue
+            results[name] = entry[metric] * UNIT_SCALE[entry.get("time_unit", "ns")]
+    return results
+
+
+def format_time(nanoseconds):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if nanoseconds >= scale:
+            return f"{nanoseconds / scale:.3g} {unit}"
+    return f"{nanoseconds:.3g} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="slowdown in percent that counts as a regression (default 5)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time")
+    arguments = parser.parse_args()
+
+    baseline = load_results(arguments.baseline, arguments.metric)
+    contender = load_results(arguments.contender, arguments.metric)
+
+    regressions = 0
+    width = max((len(name) for name in baseline), default=10)
+    for name in sorted(baseline.keys() & contender.keys()):
+        before, after = baseline[name], contender[name]
+        change = (after - before) / before * 100.0 if before else 0.0
+        if change > arguments.threshold:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif change < -arguments.threshold:
+            verdict = "improved"
+        else:
+            verdict = ""
+        print(f"{name:<{width}}  {format_time(before):>10}  {format_time(after):>10}  {change:+7.1f}%  {verdict}")
+
+    for name in sorted(baseline.keys() - contender.keys()):
+        print(f"{name:<{width}}  missing from contender")
+    for name in sorted(contender.keys() - baseline.keys()):
+        print(f"{name:<{width}}  new in contender")
+
+    print(f"\n{regressions} regression(s) above {arguments.threshold:g}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
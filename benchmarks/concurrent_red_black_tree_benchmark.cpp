@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <optional>
+#include <random>
+#include "../source/concurrent_red_black_tree.h"
+
+namespace
+{
+    constexpr int keySpace{1 << 20};
+
+    class MutexRedBlackTree
+    {
+    public:
+        bool insert(int key, int value)
+        {
+            std::lock_guard lock{mutex};
+            if(tree.find(key))
+            {
+                return false;
+            }
+            tree.insert(key, value);
+            return true;
+        }
+
+        bool remove(int key)
+        {
+            std::lock_guard lock{mutex};
+            bool found{tree.find(key) != nullptr};
+            tree.remove(key);
+            return found;
+        }
+
+        std::optional<int> find(int key) const
+        {
+            std::lock_guard lock{mutex};
+            auto found{tree.find(key)};
+            return found? std::optional<int>{found->data} : std::nullopt;
+        }
+    private:
+        algo::RedBlackTree<int, int> tree;
+        mutable std::mutex mutex;
+    };
+
+    template<typename Tree>
+    Tree& shared_tree()
+    {
+        static Tree tree{};
+        static std::once_flag filled;
+        std::call_once(filled, []
+        {
+            for(int key{0}; key < keySpace; key += 2)
+            {
+                tree.insert(key, key);
+            }
+        });
+        return tree;
+    }
+
+    template<typename Tree>
+    void mixed_workload(benchmark::State& state)
+    {
+        Tree& tree{shared_tree<Tree>()};
+        const auto writePercent{state.range(0)};
+        std::mt19937 engine{static_cast<std::mt19937::result_type>(state.thread_index())};
+        std::uniform_int_distribution<int> keys{0, keySpace - 1};
+        std::uniform_int_distribution<int> percent{0, 99};
+        for(auto _ : state)
+        {
+            int key{keys(engine)};
+            if(percent(engine) < writePercent)
+            {
+                if(key & 1)
+                {
+                    tree.insert(key, key);
+                    tree.remove(key);
+                }
+                else
+                {
+                    benchmark::DoNotOptimize(tree.find(key));
+                }
+            }
+            else
+            {
+                benchmark::DoNotOptimize(tree.find(key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK_TEMPLATE(mixed_workload, MutexRedBlackTree)
+    ->Arg(1)->Arg(10)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(mixed_workload, algo::ConcurrentRedBlackTree<int, int>)
+    ->Arg(1)->Arg(10)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
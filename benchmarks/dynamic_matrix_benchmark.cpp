@@ -0,0 +1,220 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "../source/dynamic_matrix.h"
+#include "../source/matrix_decomposition.h"
+#include "../source/matrix_multiply.h"
+
+namespace
+{
+    using Matrix = algo::DynamicMatrix<double>;
+
+    Matrix filled_matrix(std::size_t order)
+    {
+        Matrix matrix{order};
+        double value{0};
+        for(auto& element : matrix)
+        {
+            element = value;
+            value += 0.5;
+        }
+        return matrix;
+    }
+
+    void construct(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        for(auto _ : state)
+        {
+            Matrix matrix{order};
+            benchmark::DoNotOptimize(matrix.begin());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(order * order * sizeof(double)));
+    }
+
+    void copy(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const Matrix source{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            Matrix matrix{source};
+            benchmark::DoNotOptimize(matrix.begin());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(order * order * sizeof(double)));
+    }
+
+    // Alternates between order and order / 2 so every iteration reallocates and keeps
+    // the overlapping block.
+    void resize(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        Matrix matrix{filled_matrix(order)};
+        std::size_t fresh{order / 2};
+        for(auto _ : state)
+        {
+            matrix.resize(fresh, fresh);
+            fresh = fresh == order? order / 2 : order;
+            benchmark::DoNotOptimize(matrix.begin());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void iterate(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const Matrix matrix{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            double sum{0};
+            for(const auto& element : matrix)
+            {
+                sum += element;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(order * order * sizeof(double)));
+    }
+
+    void indexed_access(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const Matrix matrix{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            double sum{0};
+            for(std::size_t row{0}; row < order; ++row)
+            {
+                for(std::size_t col{0}; col < order; ++col)
+                {
+                    sum += matrix[row, col];
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(order * order * sizeof(double)));
+    }
+
+    void flops_counter(benchmark::State& state, std::size_t order)
+    {
+        state.counters["flops"] = benchmark::Counter(2.0 * static_cast<double>(order * order * order) * static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+    }
+
+    // Row-by-row product through the public interface; the baseline any dedicated
+    // multiplication routine has to beat.
+    void multiply(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const Matrix left{filled_matrix(order)};
+        const Matrix right{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            Matrix product{order};
+            for(std::size_t row{0}; row < order; ++row)
+            {
+                for(std::size_t inner{0}; inner < order; ++inner)
+                {
+                    const double scale{left[row, inner]};
+                    for(std::size_t col{0}; col < order; ++col)
+                    {
+                        product[row, col] += scale * right[inner, col];
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(product.begin());
+        }
+        flops_counter(state, order);
+    }
+
+    void blocked_multiply(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const Matrix left{filled_matrix(order)};
+        const Matrix right{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            Matrix product{algo::multiply(left, right)};
+            benchmark::DoNotOptimize(product.begin());
+        }
+        flops_counter(state, order);
+    }
+
+    // Arguments are order, cutoff and parallel depth; flops counts the classical 2n^3 so
+    // the rate is directly comparable with the kernels above.
+    void strassen_multiply(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const algo::StrassenOptions options{static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(2))};
+        const Matrix left{filled_matrix(order)};
+        const Matrix right{filled_matrix(order)};
+        for(auto _ : state)
+        {
+            Matrix product{algo::strassen_multiply(left, right, options)};
+            benchmark::DoNotOptimize(product.begin());
+        }
+        flops_counter(state, order);
+    }
+
+    // Arguments are rows, cols and rank; a tall Gaussian matrix is the slowest case for
+    // the range finder since its spectrum does not decay.
+    void randomized_svd(benchmark::State& state)
+    {
+        const auto rows{static_cast<std::size_t>(state.range(0))};
+        const auto cols{static_cast<std::size_t>(state.range(1))};
+        const auto rank{static_cast<std::size_t>(state.range(2))};
+        const Matrix matrix{algo::gaussian_matrix<double>(rows, cols, 1)};
+        for(auto _ : state)
+        {
+            auto svd{algo::randomized_svd(matrix, rank)};
+            benchmark::DoNotOptimize(svd.singularValues.data());
+        }
+    }
+
+    // Arguments are order and eigenpair count, on a symmetric Gaussian matrix.
+    void lanczos_eigen(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const auto count{static_cast<std::size_t>(state.range(1))};
+        Matrix matrix{algo::gaussian_matrix<double>(order, order, 2)};
+        for(std::size_t row{0}; row < order; ++row)
+        {
+            for(std::size_t col{0}; col < row; ++col)
+            {
+                matrix[row, col] = matrix[col, row];
+            }
+        }
+        for(auto _ : state)
+        {
+            auto eigen{algo::lanczos_eigen(matrix, count)};
+            benchmark::DoNotOptimize(eigen.eigenvalues.data());
+        }
+    }
+
+    void orders(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->RangeMultiplier(4)->Range(16, 1024);
+    }
+}
+
+BENCHMARK(construct)->Apply(orders);
+BENCHMARK(copy)->Apply(orders);
+BENCHMARK(resize)->Apply(orders);
+BENCHMARK(iterate)->Apply(orders);
+BENCHMARK(indexed_access)->Apply(orders);
+BENCHMARK(multiply)->RangeMultiplier(2)->Range(32, 512)->Unit(benchmark::kMillisecond);
+BENCHMARK(blocked_multiply)->RangeMultiplier(2)->Range(128, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(strassen_multiply)->ArgsProduct({{1000, 2048}, {64, 128, 256}, {0}})->Unit(benchmark::kMillisecond);
+BENCHMARK(strassen_multiply)->ArgsProduct({{1000, 2048}, {128}, {1, 2}})->UseRealTime()->Unit(benchmark::kMillisecond);
+// Order 8192 is where Strassen's saved multiplications should outweigh its extra
+// additions and temporaries, so it is measured against the blocked kernel there. Each
+// matrix takes 512 MiB and a product runs for minutes, so a single iteration is timed,
+// on one thread: the sequential workspace adds about 360 MiB, but every parallel level
+// keeps all seven products live and needs several GiB more.
+BENCHMARK(blocked_multiply)->Arg(8192)->Iterations(1)->UseRealTime()->Unit(benchmark::kSecond);
+BENCHMARK(strassen_multiply)->Args({8192, 128, 0})->Iterations(1)->UseRealTime()->Unit(benchmark::kSecond);
+BENCHMARK(randomized_svd)->Args({20'000, 500, 20})->Args({100'000, 200, 50})->Unit(benchmark::kMillisecond);
+BENCHMARK(lanczos_eigen)->Args({1000, 10})->Args({2000, 20})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <random>
+#include <vector>
+#include "../source/dary_heap.h"
+#include "../source/external_sort.h"
+
+namespace
+{
+    using Value = std::uint64_t;
+
+    // dary_heap's defaulted arity keeps it from matching HeapMerger's two-parameter
+    // slot without P0522, so it goes through an alias of exactly that shape.
+    template<typename Key, typename Compare>
+    using QuaternaryHeap = algo::dary_heap<Key, Compare>;
+
+    template<typename Key, typename Compare>
+    using QuaternaryMerger = algo::HeapMerger<Key, Compare, QuaternaryHeap>;
+
+    std::vector<std::vector<Value>> sorted_sources(std::size_t sourceCount, std::size_t total)
+    {
+        std::mt19937_64 engine{sourceCount};
+        std::vector<std::vector<Value>> sources(sourceCount, std::vector<Value>(total / sourceCount));
+        for(auto& source : sources)
+        {
+            for(auto& value : source)
+            {
+                value = engine();
+            }
+            std::sort(source.begin(), source.end());
+        }
+        return sources;
+    }
+
+    // In-memory k-way merge, so the comparison isolates the merger from the I/O.
+    template<template<typename, typename> class Merger>
+    void merge(benchmark::State& state)
+    {
+        const auto sourceCount{static_cast<std::size_t>(state.range(0))};
+        constexpr std::size_t total{1 << 20};
+        const auto sources{sorted_sources(sourceCount, total)};
+        std::vector<Value> output(total);
+        for(auto _ : state)
+        {
+            std::vector<std::size_t> positions(sourceCount, 1);
+            std::vector<std::optional<Value>> initial(sourceCount);
+            for(std::size_t index{0}; index < sourceCount; ++index)
+            {
+                initial[index] = sources[index][0];
+            }
+            Merger<Value, std::less<Value>> merger{initial};
+            std::size_t next{0};
+            while(!merger.empty())
+            {
+                output[next++] = merger.top();
+                const std::size_t source{merger.top_source()};
+                if(positions[source] < sources[source].size())
+                {
+                    merger.replace_top(sources[source][positions[source]++]);
+                }
+                else
+                {
+                    merger.pop();
+                }
+            }
+            benchmark::DoNotOptimize(output.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(total));
+    }
+
+    // Arguments are the value count, the memory budget in KiB and the run generation
+    // threads. The input sits in the page cache after the first iteration.
+    template<template<typename, typename> class Merger>
+    void external_sort(benchmark::State& state)
+    {
+        const auto count{static_cast<std::size_t>(state.range(0))};
+        const auto directory{std::filesystem::temp_directory_path()};
+        const auto input{directory / "external_sort_benchmark_input"};
+        const auto output{directory / "external_sort_benchmark_output"};
+        {
+            std::mt19937_64 engine{count};
+            std::vector<Value> values(count);
+            for(auto& value : values)
+            {
+                value = engine();
+            }
+            std::ofstream stream{input, std::ios::binary};
+            stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(Value)));
+        }
+        const algo::ExternalSortOptions options{static_cast<std::size_t>(state.range(1)) << 10, std::size_t{256} << 10, 0,
+                                                static_cast<std::size_t>(state.range(2)), directory};
+        algo::ExternalSortStats stats{};
+        for(auto _ : state)
+        {
+            stats = algo::external_sort<Value, std::less<Value>, Merger>(input, output, options);
+        }
+        std::filesystem::remove(input);
+        std::filesystem::remove(output);
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count * sizeof(Value)));
+        state.counters["runs"] = static_cast<double>(stats.runs);
+        state.counters["passes"] = static_cast<double>(stats.mergePasses);
+        state.counters["run_seconds"] = stats.runSeconds;
+        state.counters["merge_seconds"] = stats.mergeSeconds;
+    }
+}
+
+BENCHMARK_TEMPLATE(merge, algo::LoserTree)->RangeMultiplier(8)->Range(4, 2048);
+BENCHMARK_TEMPLATE(merge, algo::FibonacciMerger)->RangeMultiplier(8)->Range(4, 2048);
+BENCHMARK_TEMPLATE(merge, QuaternaryMerger)->RangeMultiplier(8)->Range(4, 2048);
+BENCHMARK_TEMPLATE(external_sort, algo::LoserTree)->Args({1 << 22, 4096, 1})->Args({1 << 22, 4096, 2})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(external_sort, algo::FibonacciMerger)->Args({1 << 22, 4096, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
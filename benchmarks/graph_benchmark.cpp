@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+#include "../source/fibonacci_heap.h"
+#include "../source/graph.h"
+#include "../source/pairing_heap.h"
+#include "../source/parallel_graph_search.h"
+#include "../source/radix_heap.h"
+
+namespace
+{
+    using Graph = algo::CompressedGraph<std::uint32_t>;
+    using Edge = Graph::edge_type;
+
+    template<typename Key>
+    using FibonacciHeap = algo::fibonacci_heap<Key>;
+
+    template<typename Key>
+    using PairingHeap = algo::pairing_heap<Key>;
+
+    template<typename Key>
+    using BinaryHeap = algo::dary_heap<Key, std::less<Key>, 2>;
+
+    template<typename Key>
+    using RadixHeap = algo::radix_heap<Key>;
+
+    // A square grid with a few random shortcuts: low degree, large diameter and
+    // travel-time weights, which is the shape of a road network.
+    const Graph& road_graph()
+    {
+        static const Graph graph{[]
+        {
+            constexpr std::uint32_t side{1000};
+            std::minstd_rand engine{1};
+            std::vector<Edge> edges;
+            for(std::uint32_t row{0}; row < side; ++row)
+            {
+                for(std::uint32_t column{0}; column < side; ++column)
+                {
+                    std::uint32_t vertex{row * side + column};
+                    if(column + 1 < side)
+                    {
+                        edges.push_back(Edge{vertex, vertex + 1, static_cast<std::uint32_t>(10 + engine() % 90)});
+                    }
+                    if(row + 1 < side)
+                    {
+                        edges.push_back(Edge{vertex, vertex + side, static_cast<std::uint32_t>(10 + engine() % 90)});
+                    }
+                    if(engine() % 100 == 0)
+                    {
+                        edges.push_back(Edge{vertex, static_cast<std::uint32_t>(engine() % (side * side)), static_cast<std::uint32_t>(500 + engine() % 500)});
+                    }
+                }
+            }
+            return Graph{side * side, edges, algo::GraphKind::undirected};
+        }()};
+        return graph;
+    }
+
+    // Preferential attachment: each new vertex links to endpoints of earlier edges,
+    // so degrees follow a power law and a few hubs reach most of the graph.
+    const Graph& power_law_graph()
+    {
+        static const Graph graph{[]
+        {
+            constexpr std::uint32_t vertices{1'000'000};
+            constexpr std::uint32_t links{4};
+            std::minstd_rand engine{2};
+            std::vector<Edge> edges;
+            edges.push_back(Edge{0, 1, 1});
+            for(std::uint32_t vertex{2}; vertex < vertices; ++vertex)
+            {
+                for(std::uint32_t link{0}; link < links; ++link)
+                {
+                    const Edge& chosen{edges[engine() % edges.size()]};
+                    std::uint32_t target{engine() % 2? chosen.source : chosen.target};
+                    edges.push_back(Edge{vertex, target, static_cast<std::uint32_t>(1 + engine() % 1000)});
+                }
+            }
+            return Graph{vertices, edges, algo::GraphKind::undirected};
+        }()};
+        return graph;
+    }
+
+    template<template<typename> class Heap,
+             const Graph& (*build)()>
+    void dijkstra(benchmark::State& state)
+    {
+        const Graph& graph{build()};
+        algo::GraphSearch<std::uint32_t, Heap> search{graph};
+        std::mt19937 engine{42};
+        std::int64_t settled{0};
+        for(auto _ : state)
+        {
+            search.dijkstra(static_cast<std::uint32_t>(engine() % graph.vertex_count()));
+            settled += static_cast<std::int64_t>(search.settled_count());
+        }
+        state.SetItemsProcessed(settled);
+    }
+
+    // Arguments are the thread count and the MultiQueue lanes per thread. wasted_work
+    // is the share of pops beyond the one per reached vertex a sequential search needs.
+    template<const Graph& (*build)()>
+    void parallel_dijkstra(benchmark::State& state)
+    {
+        const Graph& graph{build()};
+        algo::ParallelGraphSearch<std::uint32_t> search{graph, static_cast<std::size_t>(state.range(0)),
+                                                        static_cast<std::size_t>(state.range(1))};
+        std::mt19937 engine{42};
+        std::int64_t reached{0};
+        std::int64_t pops{0};
+        for(auto _ : state)
+        {
+            const auto work{search.dijkstra(static_cast<std::uint32_t>(engine() % graph.vertex_count()))};
+            reached += static_cast<std::int64_t>(work.reached);
+            pops += static_cast<std::int64_t>(work.expanded + work.stale);
+        }
+        state.SetItemsProcessed(reached);
+        state.counters["wasted_work"] = static_cast<double>(pops - reached) / static_cast<double>(reached);
+    }
+
+    void thread_counts(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"threads", "lanes"});
+        for(std::int64_t threads : {1, 2, 4, 8, 16, 32, 64})
+        {
+            benchmark->Args({threads, 2});
+        }
+        for(std::int64_t lanes : {1, 4, 8})
+        {
+            benchmark->Args({8, lanes});
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(dijkstra, FibonacciHeap, road_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, PairingHeap, road_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, algo::QuaternaryHeap, road_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, BinaryHeap, road_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, RadixHeap, road_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, FibonacciHeap, power_law_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, PairingHeap, power_law_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, algo::QuaternaryHeap, power_law_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, BinaryHeap, power_law_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(dijkstra, RadixHeap, power_law_graph)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_dijkstra, road_graph)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_dijkstra, power_law_graph)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
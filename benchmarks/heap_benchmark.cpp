@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../source/dary_heap.h"
+#include "../source/fibonacci_heap.h"
+#include "../source/multi_queue.h"
+#include "../source/pairing_heap.h"
+#include "../source/radix_heap.h"
+
+namespace
+{
+    using Entry = std::pair<std::uint64_t, std::uint32_t>;
+
+    using FibonacciHeap = algo::fibonacci_heap<Entry>;
+    using PairingHeap = algo::pairing_heap<Entry>;
+    using QuaternaryHeap = algo::dary_heap<Entry>;
+    using BinaryHeap = algo::dary_heap<Entry, std::less<Entry>, 2>;
+    using RadixHeap = algo::radix_heap<Entry>;
+    using StandardHeap = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+    std::vector<Entry> random_entries(std::size_t size)
+    {
+        std::mt19937_64 engine{size};
+        std::vector<Entry> entries(size);
+        for(std::size_t index{0}; index < size; ++index)
+        {
+            entries[index] = Entry{engine() % (size * 16), static_cast<std::uint32_t>(index)};
+        }
+        return entries;
+    }
+
+    template<typename Heap>
+    void push_pop(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto entries{random_entries(size)};
+        for(auto _ : state)
+        {
+            Heap heap;
+            for(const auto& entry : entries)
+            {
+                heap.push(entry);
+            }
+            std::uint64_t sum{0};
+            while(!heap.empty())
+            {
+                sum += heap.top().first;
+                heap.pop();
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    // Shaped like Dijkstra on a sparse graph: every pop is followed by a few
+    // decrease_key calls on pending entries, all staying above the popped key.
+    template<typename Heap>
+    void decrease_key_heavy(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto entries{random_entries(size)};
+        std::vector<typename Heap::handle> handles(size);
+        std::vector<std::uint64_t> keys(size);
+        std::vector<bool> popped(size);
+        for(auto _ : state)
+        {
+            std::mt19937_64 engine{7};
+            Heap heap;
+            for(const auto& entry : entries)
+            {
+                handles[entry.second] = heap.push(entry);
+                keys[entry.second] = entry.first;
+            }
+            std::fill(popped.begin(), popped.end(), false);
+            while(!heap.empty())
+            {
+                const Entry top{heap.top()};
+                heap.pop();
+                popped[top.second] = true;
+                for(int relax{0}; relax < 4; ++relax)
+                {
+                    const auto target{static_cast<std::uint32_t>(engine() % size)};
+                    if(!popped[target]
+                       && keys[target] > top.first)
+                    {
+                        keys[target] = top.first + (keys[target] - top.first) / 2;
+                        heap.decrease_key(handles[target], Entry{keys[target], target});
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(keys.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    // Pops a shuffled permutation from one thread and reports how many smaller keys
+    // were still queued at each pop, counted with a Fenwick tree over the keys.
+    void multi_queue_rank_error(benchmark::State& state)
+    {
+        const auto lanes{static_cast<std::size_t>(state.range(0))};
+        constexpr std::size_t size{1'000'000};
+        std::vector<std::uint32_t> keys(size);
+        for(std::size_t index{0}; index < size; ++index)
+        {
+            keys[index] = static_cast<std::uint32_t>(index);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64{size});
+        std::vector<std::uint32_t> present(size + 1);
+        double rankError{0};
+        for(auto _ : state)
+        {
+            algo::MultiQueue<std::uint32_t> queue{lanes};
+            std::fill(present.begin(), present.end(), 0);
+            for(auto key : keys)
+            {
+                queue.push(key);
+                for(std::size_t index{key + 1}; index <= size; index += index & (~index + 1))
+                {
+                    ++present[index];
+                }
+            }
+            std::uint64_t total{0};
+            while(auto key{queue.try_pop()})
+            {
+                for(std::size_t index{*key}; index > 0; index -= index & (~index + 1))
+                {
+                    total += present[index];
+                }
+                for(std::size_t index{*key + 1}; index <= size; index += index & (~index + 1))
+                {
+                    --present[index];
+                }
+            }
+            rankError = static_cast<double>(total) / static_cast<double>(size);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+        state.counters["rank_error"] = rankError;
+    }
+
+    void sizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->Arg(10'000)->Arg(1'000'000);
+    }
+}
+
+BENCHMARK_TEMPLATE(push_pop, StandardHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(push_pop, FibonacciHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(push_pop, PairingHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(push_pop, QuaternaryHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(push_pop, BinaryHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(push_pop, RadixHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(decrease_key_heavy, FibonacciHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(decrease_key_heavy, PairingHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(decrease_key_heavy, QuaternaryHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(decrease_key_heavy, BinaryHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(decrease_key_heavy, RadixHeap)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(multi_queue_rank_error)->Arg(1)->Arg(2)->Arg(8)->Arg(32)->Arg(128)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "../source/dynamic_matrix.h"
+#include "../source/out_of_core_multiply.h"
+#include "../source/scratch_directory.h"
+
+namespace
+{
+    using Matrix = algo::DynamicMatrix<double>;
+
+    // The operands are small enough to sit in the page cache once written, so the read
+    // rate is an upper bound on what a cold disk would give.
+    std::filesystem::path operand(const algo::ScratchDirectory& scratch, std::size_t order, std::size_t tileSize, const char* name)
+    {
+        const auto path{scratch.path() / name};
+        Matrix matrix{order};
+        double value{0};
+        for(auto& element : matrix)
+        {
+            element = value;
+            value += 0.25;
+        }
+        algo::write_tiled_matrix(path, matrix, tileSize);
+        return path;
+    }
+
+    // Arguments are order, tile size and memory budget in tiles.
+    void out_of_core_multiply(benchmark::State& state)
+    {
+        const auto order{static_cast<std::size_t>(state.range(0))};
+        const auto tileSize{static_cast<std::size_t>(state.range(1))};
+        const algo::OutOfCoreOptions options{static_cast<std::size_t>(state.range(2)) * tileSize * tileSize * sizeof(double)};
+        // Holds the operands and the product of this run and removes them when it ends,
+        // so no stale or partial file from an earlier run is ever measured.
+        const algo::ScratchDirectory scratch{std::filesystem::temp_directory_path(), "out_of_core_benchmark_"};
+        const auto lhs{operand(scratch, order, tileSize, "lhs")};
+        const auto rhs{operand(scratch, order, tileSize, "rhs")};
+        const auto product{scratch.path() / "product"};
+        algo::OutOfCoreStats total{};
+        for(auto _ : state)
+        {
+            const auto stats{algo::out_of_core_multiply<double>(lhs, rhs, product, options)};
+            total.bytesRead += stats.bytesRead;
+            total.readSeconds += stats.readSeconds;
+            total.flops += stats.flops;
+            total.computeSeconds += stats.computeSeconds;
+            total.stallSeconds += stats.stallSeconds;
+            total.residentBytes = stats.residentBytes;
+        }
+        state.counters["read_bytes_per_second"] = total.read_throughput();
+        state.counters["compute_flops"] = total.compute_throughput();
+        state.counters["overlap"] = total.overlap();
+        state.counters["resident_bytes"] = static_cast<double>(total.residentBytes);
+    }
+}
+
+BENCHMARK(out_of_core_multiply)->ArgsProduct({{1024, 2048}, {128, 256}, {5, 32}})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
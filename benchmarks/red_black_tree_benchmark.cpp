@@ -0,0 +1,319 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../source/red_black_tree.h"
+
+namespace
+{
+    using Tree = algo::RedBlackTree<std::int64_t, std::int64_t>;
+
+    enum class KeyOrder
+    {
+        ascending,
+        uniform,
+        clustered
+    };
+
+    // ascending is the worst case for rebalancing, uniform the textbook case, and
+    // clustered keys arrive as short runs around random centres, like timestamps
+    // from many producers.
+    std::vector<std::int64_t> make_keys(KeyOrder order, std::size_t size)
+    {
+        std::vector<std::int64_t> keys(size);
+        std::iota(keys.begin(), keys.end(), std::int64_t{0});
+        std::mt19937_64 engine{size};
+        switch(order)
+        {
+        case KeyOrder::ascending:
+            break;
+        case KeyOrder::uniform:
+            std::shuffle(keys.begin(), keys.end(), engine);
+            break;
+        case KeyOrder::clustered:
+        {
+            constexpr std::size_t run{64};
+            std::vector<std::size_t> runs((size + run - 1) / run);
+            std::iota(runs.begin(), runs.end(), std::size_t{0});
+            std::shuffle(runs.begin(), runs.end(), engine);
+            std::size_t next{0};
+            for(auto start : runs)
+            {
+                for(std::size_t index{start * run}; index < std::min(size, (start + 1) * run); ++index)
+                {
+                    keys[next++] = static_cast<std::int64_t>(index);
+                }
+            }
+            break;
+        }
+        }
+        return keys;
+    }
+
+    Tree make_tree(const std::vector<std::int64_t>& keys)
+    {
+        Tree tree;
+        for(auto key : keys)
+        {
+            tree.insert(key, key);
+        }
+        return tree;
+    }
+
+    template<KeyOrder order>
+    void insert(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto keys{make_keys(order, size)};
+        for(auto _ : state)
+        {
+            Tree tree{make_tree(keys)};
+            benchmark::DoNotOptimize(tree.empty());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    template<KeyOrder order>
+    void remove(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto keys{make_keys(order, size)};
+        for(auto _ : state)
+        {
+            state.PauseTiming();
+            Tree tree{make_tree(keys)};
+            state.ResumeTiming();
+            for(auto key : keys)
+            {
+                tree.remove(key);
+            }
+            benchmark::DoNotOptimize(tree.empty());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    template<KeyOrder order>
+    void lookup(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto keys{make_keys(order, size)};
+        const Tree tree{make_tree(keys)};
+        auto probes{make_keys(KeyOrder::uniform, size)};
+        std::size_t next{0};
+        for(auto _ : state)
+        {
+            benchmark::DoNotOptimize(tree.find(probes[next]));
+            next = next + 1 == size? 0 : next + 1;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<KeyOrder order>
+    void scan(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const Tree tree{make_tree(make_keys(order, size))};
+        for(auto _ : state)
+        {
+            std::int64_t sum{0};
+            tree.for_each([&](std::int64_t, std::int64_t value)
+            {
+                sum += value;
+            });
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    void sizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->RangeMultiplier(10)->Range(1'000, 1'000'000);
+    }
+
+    // std::allocator under another name, so ThreadSafeAllocator does not list it and
+    // the set operations run on the calling thread only.
+    template<typename Type>
+    struct SequentialAllocator : std::allocator<Type>
+    {
+        template<typename Other>
+        struct rebind
+        {
+            using other = SequentialAllocator<Other>;
+        };
+
+        SequentialAllocator() = default;
+
+        template<typename Other>
+        SequentialAllocator(const SequentialAllocator<Other>&) noexcept
+        {
+        }
+    };
+
+    using SequentialTree = algo::RedBlackTree<std::int64_t, std::int64_t, std::less<std::int64_t>,
+                                              algo::RedBlackNode<std::int64_t, std::int64_t>,
+                                              SequentialAllocator<algo::RedBlackNode<std::int64_t, std::int64_t>>>;
+
+    enum class SetOperation
+    {
+        unite,
+        intersect,
+        subtract
+    };
+
+    enum class Strategy
+    {
+        parallel,
+        sequential,
+        per_element
+    };
+
+    // Both operands draw from keys [0, 2 * size), so about half of rhs is in lhs.
+    template<typename TreeType>
+    std::pair<TreeType, TreeType> make_operands(std::size_t size)
+    {
+        auto keys{make_keys(KeyOrder::uniform, 2 * size)};
+        TreeType lhs;
+        TreeType rhs;
+        for(std::size_t index{0}; index < size; ++index)
+        {
+            lhs.insert(keys[index], keys[index]);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64{size + 1});
+        for(std::size_t index{0}; index < size / 2; ++index)
+        {
+            rhs.insert(keys[index], keys[index]);
+        }
+        return {std::move(lhs), std::move(rhs)};
+    }
+
+    template<typename TreeType>
+    void apply(SetOperation operation, TreeType& lhs, TreeType&& rhs)
+    {
+        switch(operation)
+        {
+        case SetOperation::unite:
+            lhs.set_union(std::move(rhs));
+            break;
+        case SetOperation::intersect:
+            lhs.set_intersection(std::move(rhs));
+            break;
+        case SetOperation::subtract:
+            lhs.set_difference(std::move(rhs));
+            break;
+        }
+    }
+
+    // The baseline a caller without the bulk operations would write: insert or
+    // remove rhs one key at a time, or rebuild lhs from its keys found in rhs.
+    void apply_per_element(SetOperation operation, Tree& lhs, const Tree& rhs)
+    {
+        switch(operation)
+        {
+        case SetOperation::unite:
+            rhs.for_each([&](std::int64_t key, std::int64_t value)
+            {
+                lhs.insert(key, value);
+            });
+            break;
+        case SetOperation::intersect:
+        {
+            Tree result;
+            lhs.for_each([&](std::int64_t key, std::int64_t value)
+            {
+                if(rhs.contains(key))
+                {
+                    result.insert(key, value);
+                }
+            });
+            lhs = std::move(result);
+            break;
+        }
+        case SetOperation::subtract:
+            rhs.for_each([&](std::int64_t key, std::int64_t)
+            {
+                lhs.remove(key);
+            });
+            break;
+        }
+    }
+
+    template<typename TreeType, SetOperation operation, Strategy strategy>
+    void set_operation_with(benchmark::State& state)
+    {
+        const auto size{static_cast<std::size_t>(state.range(0))};
+        const auto [lhs, rhs]{make_operands<TreeType>(size)};
+        for(auto _ : state)
+        {
+            state.PauseTiming();
+            TreeType result{lhs};
+            TreeType operand{rhs};
+            state.ResumeTiming();
+            if constexpr(strategy == Strategy::per_element)
+            {
+                apply_per_element(operation, result, operand);
+            }
+            else
+            {
+                apply(operation, result, std::move(operand));
+            }
+            benchmark::DoNotOptimize(result.empty());
+            state.PauseTiming();
+            result.clear();
+            operand.clear();
+            state.ResumeTiming();
+        }
+        // Forks nest bit_width(hardware_concurrency) + 1 levels deep, one thread per leaf.
+        const auto threads{strategy == Strategy::parallel? std::size_t{1} << (std::bit_width(std::thread::hardware_concurrency()) + 1) : 1};
+        state.counters["threads"] = static_cast<double>(threads);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size + size / 2));
+    }
+
+    template<SetOperation operation, Strategy strategy>
+    void set_operation(benchmark::State& state)
+    {
+        if constexpr(strategy == Strategy::sequential)
+        {
+            set_operation_with<SequentialTree, operation, strategy>(state);
+        }
+        else
+        {
+            set_operation_with<Tree, operation, strategy>(state);
+        }
+    }
+
+    void set_sizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->Arg(1'000'000)->Arg(10'000'000)->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+    }
+}
+
+BENCHMARK_TEMPLATE(insert, KeyOrder::ascending)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(insert, KeyOrder::uniform)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(insert, KeyOrder::clustered)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(remove, KeyOrder::ascending)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(remove, KeyOrder::uniform)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(remove, KeyOrder::clustered)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(lookup, KeyOrder::ascending)->Apply(sizes);
+BENCHMARK_TEMPLATE(lookup, KeyOrder::uniform)->Apply(sizes);
+BENCHMARK_TEMPLATE(lookup, KeyOrder::clustered)->Apply(sizes);
+BENCHMARK_TEMPLATE(scan, KeyOrder::ascending)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(scan, KeyOrder::uniform)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(scan, KeyOrder::clustered)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(set_operation, SetOperation::unite, Strategy::parallel)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::unite, Strategy::sequential)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::unite, Strategy::per_element)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::intersect, Strategy::parallel)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::intersect, Strategy::sequential)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::intersect, Strategy::per_element)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::subtract, Strategy::parallel)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::subtract, Strategy::sequential)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(set_operation, SetOperation::subtract, Strategy::per_element)->Apply(set_sizes);
+
+BENCHMARK_MAIN();
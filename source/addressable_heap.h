@@ -0,0 +1,27 @@
+#ifndef ADDRESSABLE_HEAP_H
+#define ADDRESSABLE_HEAP_H
+
+#include <concepts>
+#include <cstddef>
+
+namespace algo
+{
+    // push returns a handle that stays usable for decrease_key and erase until the
+    // entry leaves the heap; top is the entry no other entry is ordered before.
+    template<typename Heap>
+    concept AddressableHeap = requires(Heap heap, const Heap constHeap, 
+                                       const typename Heap::key_type& key, 
+                                       typename Heap::handle handle)
+    {
+        { heap.push(key) } -> std::same_as<typename Heap::handle>;
+        { constHeap.top() } -> std::convertible_to<const typename Heap::key_type&>;
+        heap.pop();
+        heap.decrease_key(handle, key);
+        heap.erase(handle);
+        heap.clear();
+        { constHeap.size() } -> std::convertible_to<std::size_t>;
+        { constHeap.empty() } -> std::convertible_to<bool>;
+    };
+}
+
+#endif
@@ -0,0 +1,718 @@
+#ifndef B_TREE_H
+#define B_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace algo
+{
+    template<typename Key,
+             typename Compare>
+    struct BTreeKeySearch
+    {
+        static std::size_t count_less(const Key* keys, std::size_t count, const Key& key, const Compare& compare)
+        {
+            return static_cast<std::size_t>(std::lower_bound(keys, keys + count, key, compare) - keys);
+        }
+
+        static std::size_t count_less_equal(const Key* keys, std::size_t count, const Key& key, const Compare& compare)
+        {
+            return static_cast<std::size_t>(std::upper_bound(keys, keys + count, key, compare) - keys);
+        }
+    };
+
+    // Nodes are a few cache lines wide, so for plain integers a branchless scan of the
+    // whole node beats a binary search; with AVX2 it compares a full vector at a time.
+    template<typename Key>
+        requires std::is_arithmetic_v<Key>
+    struct BTreeKeySearch<Key, std::less<Key>>
+    {
+        static std::size_t count_less(const Key* keys, std::size_t count, const Key& key, const std::less<Key>&)
+        {
+            std::size_t index{0};
+            std::size_t result{0};
+#if defined(__AVX2__)
+            if constexpr(std::is_integral_v<Key> && std::is_signed_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8))
+            {
+                constexpr std::size_t lanes{32 / sizeof(Key)};
+                const __m256i probe{broadcast(key)};
+                for(; index + lanes <= count; index += lanes)
+                {
+                    __m256i block{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index))};
+                    result += count_mask(greater(probe, block));
+                }
+            }
+#endif
+            for(; index < count; ++index)
+            {
+                result += keys[index] < key;
+            }
+            return result;
+        }
+
+        static std::size_t count_less_equal(const Key* keys, std::size_t count, const Key& key, const std::less<Key>&)
+        {
+            std::size_t index{0};
+            std::size_t result{0};
+#if defined(__AVX2__)
+            if constexpr(std::is_integral_v<Key> && std::is_signed_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8))
+            {
+                constexpr std::size_t lanes{32 / sizeof(Key)};
+                const __m256i probe{broadcast(key)};
+                for(; index + lanes <= count; index += lanes)
+                {
+                    __m256i block{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index))};
+                    result += lanes - count_mask(greater(block, probe));
+                }
+            }
+#endif
+            for(; index < count; ++index)
+            {
+                result += !(key < keys[index]);
+            }
+            return result;
+        }
+    private:
+#if defined(__AVX2__)
+        static __m256i broadcast(const Key& key) noexcept
+        {
+            if constexpr(sizeof(Key) == 4)
+            {
+                return _mm256_set1_epi32(static_cast<std::int32_t>(key));
+            }
+            else
+            {
+                return _mm256_set1_epi64x(static_cast<std::int64_t>(key));
+            }
+        }
+
+        static __m256i greater(__m256i lhs, __m256i rhs) noexcept
+        {
+            if constexpr(sizeof(Key) == 4)
+            {
+                return _mm256_cmpgt_epi32(lhs, rhs);
+            }
+            else
+            {
+                return _mm256_cmpgt_epi64(lhs, rhs);
+            }
+        }
+
+        static std::size_t count_mask(__m256i mask) noexcept
+        {
+            return static_cast<std::size_t>(std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(mask)))) / sizeof(Key);
+        }
+#endif
+    };
+
+    template<typename Key,
+             typename Type,
+             typename Compare = std::less<Key>,
+             std::size_t NodeBytes = 256>
+    class BTree
+    {
+        struct Node;
+        struct Leaf;
+        struct Inner;
+    public:
+        using key_type = Key;
+        using value_type = Type;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        static constexpr size_type cacheLine{64};
+        static constexpr size_type leafCapacity{std::max<size_type>(3, (NodeBytes - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(Type)))};
+        static constexpr size_type innerCapacity{std::max<size_type>(3, (NodeBytes - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)))};
+
+        // Leaves are linked, so the iterators are a leaf and a slot. Both flavours share
+        // this template; only the value reference differs, and a mutable iterator
+        // converts to a const one.
+        template<bool Constant>
+        struct basic_iterator
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const Key&, std::conditional_t<Constant, const Type&, Type&>>;
+            using reference = value_type;
+            using leaf_pointer = std::conditional_t<Constant, const Leaf*, Leaf*>;
+
+            struct ArrowProxy
+            {
+                value_type entry;
+
+                value_type* operator->() noexcept
+                {
+                    return &entry;
+                }
+            };
+
+            basic_iterator() = default;
+
+            basic_iterator(leaf_pointer leaf, size_type slot) noexcept
+                : leaf{leaf}, slot{slot}
+            {
+            }
+
+            template<bool OtherConstant>
+                requires (Constant && !OtherConstant)
+            basic_iterator(const basic_iterator<OtherConstant>& that) noexcept
+                : leaf{that.leaf}, slot{that.slot}
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return reference{leaf->keys[slot], leaf->values[slot]};
+            }
+
+            ArrowProxy operator->() const noexcept
+            {
+                return ArrowProxy{**this};
+            }
+
+            basic_iterator& operator++() noexcept
+            {
+                if(++slot == leaf->count)
+                {
+                    leaf = leaf->next;
+                    slot = 0;
+                }
+                return *this;
+            }
+
+            basic_iterator operator++(int) noexcept
+            {
+                auto copy{*this};
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const basic_iterator& that) const noexcept
+            {
+                return leaf == that.leaf && slot == that.slot;
+            }
+
+            leaf_pointer leaf{nullptr};
+            size_type slot{0};
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        BTree()
+            : root{nullptr}, elements{0}
+            , compare{}
+        {
+        }
+
+        BTree(const BTree&) = delete;
+        BTree& operator=(const BTree&) = delete;
+
+        BTree(BTree&& that) noexcept
+            : root{that.root}, elements{that.elements}
+            , compare{std::move(that.compare)}
+        {
+            that.root = nullptr;
+            that.elements = 0;
+        }
+
+        BTree& operator=(BTree&& that) noexcept
+        {
+            BTree{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        ~BTree()
+        {
+            clear();
+        }
+
+        template<typename... Args>
+        iterator emplace(const key_type& key, Args&&... args)
+        {
+            if(root == nullptr)
+            {
+                root = make_leaf();
+            }
+            iterator position{};
+            std::optional<std::pair<key_type, Node*>> split{insert_into(root, key, &position, std::forward<Args>(args)...)};
+            if(split)
+            {
+                Inner* fresh{make_inner()};
+                fresh->keys[0] = std::move(split->first);
+                fresh->children[0] = root;
+                fresh->children[1] = split->second;
+                fresh->count = 1;
+                root = fresh;
+            }
+            return position;
+        }
+
+        iterator insert(const key_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        void remove(const key_type& key)
+        {
+            if(root == nullptr
+               || !remove_from(root, key))
+            {
+                return;
+            }
+            if(root->count == 0)
+            {
+                Node* empty{root};
+                root = root->leaf? nullptr : static_cast<Inner*>(root)->children[0];
+                destroy_node(empty, false);
+            }
+        }
+
+        reference operator[](const key_type& key)
+        {
+            return emplace(key, value_type{})->second;
+        }
+
+        iterator find(const key_type& key)
+        {
+            auto [leaf, slot]{find_slot(key)};
+            return iterator{leaf, slot};
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            auto [leaf, slot]{find_slot(key)};
+            return const_iterator{leaf, slot};
+        }
+
+        iterator lower_bound(const key_type& key)
+        {
+            auto [leaf, slot]{lower_bound_slot(key)};
+            return iterator{leaf, slot};
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            auto [leaf, slot]{lower_bound_slot(key)};
+            return const_iterator{leaf, slot};
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find_slot(key).first != nullptr;
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator{first_leaf(), 0};
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{first_leaf(), 0};
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        iterator end() noexcept
+        {
+            return iterator{};
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{};
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        size_type size() const noexcept
+        {
+            return elements;
+        }
+
+        bool empty() const noexcept
+        {
+            return elements == 0;
+        }
+
+        void swap(BTree& that) noexcept
+        {
+            std::swap(this->root, that.root);
+            std::swap(this->elements, that.elements);
+            std::swap(this->compare, that.compare);
+        }
+
+        void clear()
+        {
+            if(root)
+            {
+                destroy_node(root, true);
+            }
+            root = nullptr;
+            elements = 0;
+        }
+    private:
+        using search = BTreeKeySearch<Key, Compare>;
+
+        // Where key is or would go, as a leaf and slot; a null leaf is end().
+        std::pair<Leaf*, size_type> lower_bound_slot(const key_type& key) const
+        {
+            if(root == nullptr)
+            {
+                return {nullptr, 0};
+            }
+            Node* position{root};
+            while(!position->leaf)
+            {
+                Inner* inner{static_cast<Inner*>(position)};
+                position = inner->children[search::count_less_equal(inner->keys.data(), inner->count, key, compare)];
+            }
+            Leaf* leaf{static_cast<Leaf*>(position)};
+            size_type slot{search::count_less(leaf->keys.data(), leaf->count, key, compare)};
+            if(slot == leaf->count)
+            {
+                return {leaf->next, 0};
+            }
+            return {leaf, slot};
+        }
+
+        std::pair<Leaf*, size_type> find_slot(const key_type& key) const
+        {
+            auto [leaf, slot]{lower_bound_slot(key)};
+            if(leaf
+               && !compare(key, leaf->keys[slot]))
+            {
+                return {leaf, slot};
+            }
+            return {nullptr, 0};
+        }
+
+        Leaf* first_leaf() const noexcept
+        {
+            Node* position{root};
+            while(position && !position->leaf)
+            {
+                position = static_cast<Inner*>(position)->children[0];
+            }
+            return position && position->count? static_cast<Leaf*>(position) : nullptr;
+        }
+
+        struct Node
+        {
+            std::uint16_t count{0};
+            bool leaf;
+        };
+
+        struct alignas(cacheLine) Leaf : Node
+        {
+            Leaf()
+                : Node{0, true}
+            {
+            }
+
+            std::array<Key, leafCapacity> keys{};
+            std::array<Type, leafCapacity> values{};
+            Leaf* next{nullptr};
+        };
+
+        struct alignas(cacheLine) Inner : Node
+        {
+            Inner()
+                : Node{0, false}
+            {
+            }
+
+            std::array<Key, innerCapacity> keys{};
+            std::array<Node*, innerCapacity + 1> children{};
+        };
+
+        using leaf_allocator = std::allocator<Leaf>;
+        using inner_allocator = std::allocator<Inner>;
+
+        static constexpr size_type leafMinimum{leafCapacity / 2};
+        static constexpr size_type innerMinimum{innerCapacity / 2};
+
+        Leaf* make_leaf()
+        {
+            leaf_allocator alloc{};
+            Leaf* fresh{std::allocator_traits<leaf_allocator>::allocate(alloc, 1)};
+            std::allocator_traits<leaf_allocator>::construct(alloc, fresh);
+            return fresh;
+        }
+
+        Inner* make_inner()
+        {
+            inner_allocator alloc{};
+            Inner* fresh{std::allocator_traits<inner_allocator>::allocate(alloc, 1)};
+            std::allocator_traits<inner_allocator>::construct(alloc, fresh);
+            return fresh;
+        }
+
+        void destroy_node(Node* node, bool recursive)
+        {
+            if(node->leaf)
+            {
+                leaf_allocator alloc{};
+                std::allocator_traits<leaf_allocator>::destroy(alloc, static_cast<Leaf*>(node));
+                std::allocator_traits<leaf_allocator>::deallocate(alloc, static_cast<Leaf*>(node), 1);
+                return;
+            }
+            Inner* inner{static_cast<Inner*>(node)};
+            if(recursive)
+            {
+                for(size_type index{0}; index <= inner->count; ++index)
+                {
+                    destroy_node(inner->children[index], true);
+                }
+            }
+            inner_allocator alloc{};
+            std::allocator_traits<inner_allocator>::destroy(alloc, inner);
+            std::allocator_traits<inner_allocator>::deallocate(alloc, inner, 1);
+        }
+
+        template<typename... Args>
+        std::optional<std::pair<key_type, Node*>> insert_into(Node* node, const key_type& key, iterator* position, Args&&... args)
+        {
+            if(node->leaf)
+            {
+                return insert_into_leaf(static_cast<Leaf*>(node), key, position, std::forward<Args>(args)...);
+            }
+            Inner* inner{static_cast<Inner*>(node)};
+            size_type index{search::count_less_equal(inner->keys.data(), inner->count, key, compare)};
+            std::optional<std::pair<key_type, Node*>> childSplit{insert_into(inner->children[index], key, position, std::forward<Args>(args)...)};
+            if(!childSplit)
+            {
+                return std::nullopt;
+            }
+            std::optional<std::pair<key_type, Node*>> split{};
+            if(inner->count == innerCapacity)
+            {
+                split = split_inner(inner);
+                if(index > inner->count)
+                {
+                    index -= inner->count + 1;
+                    inner = static_cast<Inner*>(split->second);
+                }
+            }
+            std::move_backward(inner->keys.begin() + index, inner->keys.begin() + inner->count, inner->keys.begin() + inner->count + 1);
+            std::move_backward(inner->children.begin() + index + 1, inner->children.begin() + inner->count + 1, inner->children.begin() + inner->count + 2);
+            inner->keys[index] = std::move(childSplit->first);
+            inner->children[index + 1] = childSplit->second;
+            ++inner->count;
+            return split;
+        }
+
+        template<typename... Args>
+        std::optional<std::pair<key_type, Node*>> insert_into_leaf(Leaf* leaf, const key_type& key, iterator* position, Args&&... args)
+        {
+            size_type slot{search::count_less(leaf->keys.data(), leaf->count, key, compare)};
+            if(slot < leaf->count
+               && !compare(key, leaf->keys[slot]))
+            {
+                *position = iterator{leaf, slot};
+                return std::nullopt;
+            }
+            std::optional<std::pair<key_type, Node*>> split{};
+            if(leaf->count == leafCapacity)
+            {
+                Leaf* right{make_leaf()};
+                size_type half{static_cast<size_type>(leaf->count / 2)};
+                std::move(leaf->keys.begin() + half, leaf->keys.begin() + leaf->count, right->keys.begin());
+                std::move(leaf->values.begin() + half, leaf->values.begin() + leaf->count, right->values.begin());
+                right->count = static_cast<std::uint16_t>(leaf->count - half);
+                leaf->count = static_cast<std::uint16_t>(half);
+                right->next = leaf->next;
+                leaf->next = right;
+                if(slot > half)
+                {
+                    slot -= half;
+                    leaf = right;
+                }
+                split.emplace(key_type{}, right);
+            }
+            std::move_backward(leaf->keys.begin() + slot, leaf->keys.begin() + leaf->count, leaf->keys.begin() + leaf->count + 1);
+            std::move_backward(leaf->values.begin() + slot, leaf->values.begin() + leaf->count, leaf->values.begin() + leaf->count + 1);
+            leaf->keys[slot] = key;
+            leaf->values[slot] = value_type(std::forward<Args>(args)...);
+            ++leaf->count;
+            ++elements;
+            *position = iterator{leaf, slot};
+            if(split)
+            {
+                split->first = static_cast<Leaf*>(split->second)->keys[0];
+            }
+            return split;
+        }
+
+        std::pair<key_type, Node*> split_inner(Inner* inner)
+        {
+            Inner* right{make_inner()};
+            size_type middle{static_cast<size_type>(inner->count / 2)};
+            std::move(inner->keys.begin() + middle + 1, inner->keys.begin() + inner->count, right->keys.begin());
+            std::copy(inner->children.begin() + middle + 1, inner->children.begin() + inner->count + 1, right->children.begin());
+            right->count = static_cast<std::uint16_t>(inner->count - middle - 1);
+            inner->count = static_cast<std::uint16_t>(middle);
+            return {std::move(inner->keys[middle]), right};
+        }
+
+        bool remove_from(Node* node, const key_type& key)
+        {
+            if(node->leaf)
+            {
+                Leaf* leaf{static_cast<Leaf*>(node)};
+                size_type slot{search::count_less(leaf->keys.data(), leaf->count, key, compare)};
+                if(slot == leaf->count
+                   || compare(key, leaf->keys[slot]))
+                {
+                    return false;
+                }
+                std::move(leaf->keys.begin() + slot + 1, leaf->keys.begin() + leaf->count, leaf->keys.begin() + slot);
+                std::move(leaf->values.begin() + slot + 1, leaf->values.begin() + leaf->count, leaf->values.begin() + slot);
+                --leaf->count;
+                --elements;
+                return true;
+            }
+            Inner* inner{static_cast<Inner*>(node)};
+            size_type index{search::count_less_equal(inner->keys.data(), inner->count, key, compare)};
+            if(!remove_from(inner->children[index], key))
+            {
+                return false;
+            }
+            Node* child{inner->children[index]};
+            if(child->count < (child->leaf? leafMinimum : innerMinimum))
+            {
+                rebalance(inner, index);
+            }
+            return true;
+        }
+
+        void rebalance(Inner* parent, size_type index)
+        {
+            Node* child{parent->children[index]};
+            size_type minimum{child->leaf? leafMinimum : innerMinimum};
+            if(index > 0
+               && parent->children[index - 1]->count > minimum)
+            {
+                borrow_from_left(parent, index);
+            }
+            else if(index < parent->count
+                    && parent->children[index + 1]->count > minimum)
+            {
+                borrow_from_right(parent, index);
+            }
+            else
+            {
+                merge_children(parent, index > 0? index - 1 : index);
+            }
+        }
+
+        void borrow_from_left(Inner* parent, size_type index)
+        {
+            if(parent->children[index]->leaf)
+            {
+                Leaf* left{static_cast<Leaf*>(parent->children[index - 1])};
+                Leaf* child{static_cast<Leaf*>(parent->children[index])};
+                std::move_backward(child->keys.begin(), child->keys.begin() + child->count, child->keys.begin() + child->count + 1);
+                std::move_backward(child->values.begin(), child->values.begin() + child->count, child->values.begin() + child->count + 1);
+                child->keys[0] = std::move(left->keys[left->count - 1]);
+                child->values[0] = std::move(left->values[left->count - 1]);
+                ++child->count;
+                --left->count;
+                parent->keys[index - 1] = child->keys[0];
+                return;
+            }
+            Inner* left{static_cast<Inner*>(parent->children[index - 1])};
+            Inner* child{static_cast<Inner*>(parent->children[index])};
+            std::move_backward(child->keys.begin(), child->keys.begin() + child->count, child->keys.begin() + child->count + 1);
+            std::move_backward(child->children.begin(), child->children.begin() + child->count + 1, child->children.begin() + child->count + 2);
+            child->keys[0] = std::move(parent->keys[index - 1]);
+            child->children[0] = left->children[left->count];
+            parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+            ++child->count;
+            --left->count;
+        }
+
+        void borrow_from_right(Inner* parent, size_type index)
+        {
+            if(parent->children[index]->leaf)
+            {
+                Leaf* child{static_cast<Leaf*>(parent->children[index])};
+                Leaf* right{static_cast<Leaf*>(parent->children[index + 1])};
+                child->keys[child->count] = std::move(right->keys[0]);
+                child->values[child->count] = std::move(right->values[0]);
+                ++child->count;
+                std::move(right->keys.begin() + 1, right->keys.begin() + right->count, right->keys.begin());
+                std::move(right->values.begin() + 1, right->values.begin() + right->count, right->values.begin());
+                --right->count;
+                parent->keys[index] = right->keys[0];
+                return;
+            }
+            Inner* child{static_cast<Inner*>(parent->children[index])};
+            Inner* right{static_cast<Inner*>(parent->children[index + 1])};
+            child->keys[child->count] = std::move(parent->keys[index]);
+            child->children[child->count + 1] = right->children[0];
+            ++child->count;
+            parent->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys.begin() + 1, right->keys.begin() + right->count, right->keys.begin());
+            std::copy(right->children.begin() + 1, right->children.begin() + right->count + 1, right->children.begin());
+            --right->count;
+        }
+
+        void merge_children(Inner* parent, size_type index)
+        {
+            Node* right{parent->children[index + 1]};
+            if(right->leaf)
+            {
+                Leaf* left{static_cast<Leaf*>(parent->children[index])};
+                Leaf* donor{static_cast<Leaf*>(right)};
+                std::move(donor->keys.begin(), donor->keys.begin() + donor->count, left->keys.begin() + left->count);
+                std::move(donor->values.begin(), donor->values.begin() + donor->count, left->values.begin() + left->count);
+                left->count = static_cast<std::uint16_t>(left->count + donor->count);
+                left->next = donor->next;
+            }
+            else
+            {
+                Inner* left{static_cast<Inner*>(parent->children[index])};
+                Inner* donor{static_cast<Inner*>(right)};
+                left->keys[left->count] = std::move(parent->keys[index]);
+                std::move(donor->keys.begin(), donor->keys.begin() + donor->count, left->keys.begin() + left->count + 1);
+                std::copy(donor->children.begin(), donor->children.begin() + donor->count + 1, left->children.begin() + left->count + 1);
+                left->count = static_cast<std::uint16_t>(left->count + donor->count + 1);
+            }
+            std::move(parent->keys.begin() + index + 1, parent->keys.begin() + parent->count, parent->keys.begin() + index);
+            std::copy(parent->children.begin() + index + 2, parent->children.begin() + parent->count + 1, parent->children.begin() + index + 1);
+            --parent->count;
+            destroy_node(right, false);
+        }
+
+        Node* root;
+        size_type elements;
+        key_compare compare;
+    };
+}
+
+#endif
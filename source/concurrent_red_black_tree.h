@@ -0,0 +1,319 @@
+#ifndef CONCURRENT_RED_BLACK_TREE_H
+#define CONCURRENT_RED_BLACK_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "red_black_tree.h"
+
+namespace algo
+{
+    // Writers are serialized by a mutex and reuse the RedBlackTree algorithms inside
+    // a seqlock window. Readers never lock: they walk the tree optimistically, validate
+    // the version afterwards and retry on conflict. Unlinked nodes are kept alive by
+    // epoch based reclamation, so a reader racing with a remove never touches freed memory.
+    template<typename Key,
+             typename Type,
+             typename Compare = std::less<Key>>
+    class ConcurrentRedBlackTree
+    {
+    public:
+        using tree_type = RedBlackTree<Key, Type, Compare>;
+        using key_type = typename tree_type::key_type;
+        using value_type = typename tree_type::value_type;
+        using size_type = typename tree_type::size_type;
+        using key_compare = typename tree_type::key_compare;
+        using node_type = typename tree_type::node_type;
+        using allocator_type = typename tree_type::allocator_type;
+
+        static constexpr size_type readerSlotsNumber{128};
+        static constexpr size_type optimisticAttempts{8};
+
+        ConcurrentRedBlackTree()
+            : tree{}, writeMutex{}
+            , version{0}, globalEpoch{1}
+            , readerSlots{}, retired{}
+        {
+        }
+
+        ConcurrentRedBlackTree(const ConcurrentRedBlackTree&) = delete;
+        ConcurrentRedBlackTree& operator=(const ConcurrentRedBlackTree&) = delete;
+
+        ~ConcurrentRedBlackTree()
+        {
+            for(const auto& [node, epoch] : retired)
+            {
+                tree.destroy_node(node);
+            }
+        }
+
+        template<typename... Args>
+        bool emplace(const key_type& key, Args&&... args)
+        {
+            std::lock_guard lock{writeMutex};
+            node_type* parent{nullptr};
+            node_type** position{tree.lookup_position(key, &parent, &tree.root)};
+            if(*position)
+            {
+                return false;
+            }
+            node_type* fresh{std::allocator_traits<allocator_type>::allocate(tree.alloc, 1)};
+            std::allocator_traits<allocator_type>::construct(tree.alloc, fresh, parent, nullptr, nullptr,
+                                                             RedBlackColor::red, key, std::forward<Args>(args)...);
+            begin_write();
+            publish(position, fresh);
+            tree.insert_rebalance(fresh);
+            end_write();
+            return true;
+        }
+
+        bool insert(const key_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        bool remove(const key_type& key)
+        {
+            std::lock_guard lock{writeMutex};
+            node_type* parent{nullptr};
+            node_type* found{*tree.lookup_position(key, &parent, &tree.root)};
+            if(found == nullptr)
+            {
+                return false;
+            }
+            begin_write();
+            tree.delete_condition(found);
+            end_write();
+            retired.emplace_back(found, globalEpoch.fetch_add(1));
+            reclaim();
+            return true;
+        }
+
+        std::optional<value_type> find(const key_type& key) const
+        {
+            ReadGuard guard{*this};
+            for(size_type attempt{0}; attempt < optimisticAttempts; ++attempt)
+            {
+                std::uint64_t before{read_begin()};
+                node_type* found{nullptr};
+                if(optimistic_lookup(key, &found) && read_validate(before))
+                {
+                    return found? std::optional<value_type>{found->data} : std::nullopt;
+                }
+            }
+            std::lock_guard lock{writeMutex};
+            node_type* found{tree.find(key)};
+            return found? std::optional<value_type>{found->data} : std::nullopt;
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find(key).has_value();
+        }
+
+        std::vector<std::pair<key_type, value_type>> range(const key_type& lower, const key_type& upper) const
+        {
+            ReadGuard guard{*this};
+            std::vector<std::pair<key_type, value_type>> result;
+            for(size_type attempt{0}; attempt < optimisticAttempts; ++attempt)
+            {
+                result.clear();
+                std::uint64_t before{read_begin()};
+                if(collect_range(lower, upper, result) && read_validate(before))
+                {
+                    return result;
+                }
+            }
+            result.clear();
+            std::lock_guard lock{writeMutex};
+            collect_range(lower, upper, result);
+            return result;
+        }
+    private:
+        static constexpr size_type maxDepth{2 * std::numeric_limits<size_type>::digits};
+
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<std::uint64_t> epoch{0};
+        };
+
+        class ReadGuard
+        {
+        public:
+            explicit ReadGuard(const ConcurrentRedBlackTree& owner)
+                : owner{owner}, slot{owner.enter_epoch()}
+            {
+            }
+
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+
+            ~ReadGuard()
+            {
+                owner.readerSlots[slot].epoch.store(0, std::memory_order_release);
+            }
+        private:
+            const ConcurrentRedBlackTree& owner;
+            size_type slot;
+        };
+
+        size_type enter_epoch() const
+        {
+            static std::atomic<size_type> nextHint{0};
+            thread_local size_type hint{nextHint.fetch_add(1, std::memory_order_relaxed)};
+            while(true)
+            {
+                for(size_type offset{0}; offset < readerSlotsNumber; ++offset)
+                {
+                    size_type slot{(hint + offset) % readerSlotsNumber};
+                    std::uint64_t expected{0};
+                    if(readerSlots[slot].epoch.compare_exchange_strong(expected, globalEpoch.load()))
+                    {
+                        hint = slot;
+                        return slot;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        void reclaim()
+        {
+            std::uint64_t oldest{std::numeric_limits<std::uint64_t>::max()};
+            for(const auto& slot : readerSlots)
+            {
+                std::uint64_t epoch{slot.epoch.load()};
+                if(epoch != 0)
+                {
+                    oldest = std::min(oldest, epoch);
+                }
+            }
+            std::erase_if(retired, [&](const auto& entry)
+            {
+                if(entry.second < oldest)
+                {
+                    tree.destroy_node(entry.first);
+                    return true;
+                }
+                return false;
+            });
+        }
+
+        void begin_write() noexcept
+        {
+            version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void end_write() noexcept
+        {
+            version.store(version.load(std::memory_order_relaxed) + 1);
+        }
+
+        static void publish(node_type** position, node_type* fresh) noexcept
+        {
+            std::atomic_ref<node_type*>{*position}.store(fresh, std::memory_order_release);
+        }
+
+        static node_type* load_link(node_type* const& link) noexcept
+        {
+            return std::atomic_ref<node_type*>{const_cast<node_type*&>(link)}.load(std::memory_order_acquire);
+        }
+
+        std::uint64_t read_begin() const noexcept
+        {
+            std::uint64_t before{version.load()};
+            while(before & 1)
+            {
+                std::this_thread::yield();
+                before = version.load();
+            }
+            return before;
+        }
+
+        bool read_validate(std::uint64_t before) const noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return version.load(std::memory_order_relaxed) == before;
+        }
+
+        bool optimistic_lookup(const key_type& key, node_type** found) const
+        {
+            node_type* position{load_link(tree.root)};
+            for(size_type depth{0}; position; ++depth)
+            {
+                if(depth > maxDepth)
+                {
+                    return false;
+                }
+                if(tree.compare(key, position->key))
+                {
+                    position = load_link(position->left);
+                }
+                else if(tree.compare(position->key, key))
+                {
+                    position = load_link(position->right);
+                }
+                else
+                {
+                    break;
+                }
+            }
+            *found = position;
+            return true;
+        }
+
+        bool collect_range(const key_type& lower, const key_type& upper,
+                           std::vector<std::pair<key_type, value_type>>& result) const
+        {
+            std::array<node_type*, maxDepth> stack;
+            size_type depth{0};
+            size_type steps{0};
+            node_type* position{load_link(tree.root)};
+            while(position || depth > 0)
+            {
+                while(position)
+                {
+                    if(depth == maxDepth 
+                       || ++steps > maxDepth)
+                    {
+                        return false;
+                    }
+                    if(tree.compare(position->key, lower))
+                    {
+                        position = load_link(position->right);
+                        continue;
+                    }
+                    stack[depth++] = position;
+                    position = load_link(position->left);
+                }
+                position = stack[--depth];
+                if(tree.compare(upper, position->key))
+                {
+                    break;
+                }
+                result.emplace_back(position->key, position->data);
+                steps = 0;
+                position = load_link(position->right);
+            }
+            return true;
+        }
+
+        tree_type tree;
+        mutable std::mutex writeMutex;
+        std::atomic<std::uint64_t> version;
+        std::atomic<std::uint64_t> globalEpoch;
+        mutable std::array<ReaderSlot, readerSlotsNumber> readerSlots;
+        std::vector<std::pair<node_type*, std::uint64_t>> retired;
+    };
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef COUNTING_MEMORY_RESOURCE_H
+#define COUNTING_MEMORY_RESOURCE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+
+namespace algo
+{
+    enum class AllocationEventKind : std::uint8_t
+    {
+        allocation = 0,
+        deallocation,
+        max_allocation_event_kind,
+    };
+
+    struct AllocationEvent
+    {
+        AllocationEventKind kind;
+        void* address;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    // sizeHistogram[k] counts requests of at most 2^k bytes that did not fit in 2^(k - 1).
+    struct AllocationStats
+    {
+        static constexpr std::size_t sizeClassesNumber{std::numeric_limits<std::size_t>::digits + 1};
+
+        std::size_t allocations{0};
+        std::size_t deallocations{0};
+        std::size_t bytesAllocated{0};
+        std::size_t bytesInUse{0};
+        std::size_t peakBytesInUse{0};
+        std::array<std::size_t, sizeClassesNumber> sizeHistogram{};
+    };
+
+    // Forwards to an upstream resource and records what passes through it. Give each
+    // container its own instance to see that container's allocation profile; a tracer,
+    // if set, is called for every event. Like the unsynchronized pool resource it does
+    // no locking, so share an instance between threads only with outside synchronization.
+    // The pmr trees never fork their set operations for the same reason.
+    class CountingMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        using tracer_type = std::function<void(const AllocationEvent&)>;
+
+        CountingMemoryResource() noexcept
+            : upstream{std::pmr::get_default_resource()}, counts{}
+            , tracer{}
+        {
+        }
+
+        explicit CountingMemoryResource(std::pmr::memory_resource* upstream) noexcept
+            : upstream{upstream}, counts{}
+            , tracer{}
+        {
+        }
+
+        CountingMemoryResource(const CountingMemoryResource&) = delete;
+        CountingMemoryResource& operator=(const CountingMemoryResource&) = delete;
+
+        const AllocationStats& stats() const noexcept
+        {
+            return counts;
+        }
+
+        // Keeps bytesInUse, so outstanding blocks are still accounted for when freed.
+        void reset_stats() noexcept
+        {
+            std::size_t inUse{counts.bytesInUse};
+            counts = AllocationStats{};
+            counts.bytesInUse = inUse;
+            counts.peakBytesInUse = inUse;
+        }
+
+        void set_tracer(tracer_type fresh)
+        {
+            tracer = std::move(fresh);
+        }
+
+        std::pmr::memory_resource* upstream_resource() const noexcept
+        {
+            return upstream;
+        }
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* address{upstream->allocate(bytes, alignment)};
+            ++counts.allocations;
+            counts.bytesAllocated += bytes;
+            counts.bytesInUse += bytes;
+            counts.peakBytesInUse = std::max(counts.peakBytesInUse, counts.bytesInUse);
+            ++counts.sizeHistogram[std::bit_width(bytes == 0? 0 : bytes - 1)];
+            if(tracer)
+            {
+                tracer(AllocationEvent{AllocationEventKind::allocation, address, bytes, alignment});
+            }
+            return address;
+        }
+
+        void do_deallocate(void* address, std::size_t bytes, std::size_t alignment) override
+        {
+            ++counts.deallocations;
+            counts.bytesInUse -= bytes;
+            if(tracer)
+            {
+                tracer(AllocationEvent{AllocationEventKind::deallocation, address, bytes, alignment});
+            }
+            upstream->deallocate(address, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        std::pmr::memory_resource* upstream;
+        AllocationStats counts;
+        tracer_type tracer;
+    };
+}
+
+#endif
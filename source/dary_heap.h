@@ -0,0 +1,278 @@
+#ifndef DARY_HEAP_H
+#define DARY_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "addressable_heap.h"
+
+namespace algo
+{
+    template<typename Type>
+    struct CacheAlignedAllocator
+    {
+        using value_type = Type;
+
+        static constexpr std::size_t alignment{64};
+
+        CacheAlignedAllocator() noexcept = default;
+
+        template<typename Other>
+        CacheAlignedAllocator(const CacheAlignedAllocator<Other>&) noexcept
+        {
+        }
+
+        Type* allocate(std::size_t count)
+        {
+            return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t{alignment}));
+        }
+
+        void deallocate(Type* pointer, std::size_t) noexcept
+        {
+            ::operator delete(pointer, std::align_val_t{alignment});
+        }
+
+        template<typename Other>
+        bool operator==(const CacheAlignedAllocator<Other>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    // Keys live in a cache-line aligned array whose first Arity - 1 entries are padding,
+    // so all children of a node start on one line when Arity * sizeof(Key) is 64.
+    // Handles are slot numbers; positions maps a slot to its place in the array and
+    // slots maps back, which keeps decrease_key and erase O(log n).
+    template<typename Key,
+             typename Compare = std::less<Key>,
+             std::size_t Arity = 4>
+    class dary_heap
+    {
+        static_assert(Arity >= 2, "A heap needs at least two children per node.");
+        static_assert(std::is_default_constructible_v<Key>, "Padding entries are default constructed.");
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using handle = size_type;
+        using const_reference = const key_type&;
+
+        static constexpr size_type arity{Arity};
+
+        dary_heap()
+            : keys(padding), slots{}
+            , positions{}, freeSlots{}
+            , compare{}
+        {
+        }
+
+        explicit dary_heap(const key_compare& compare)
+            : keys(padding), slots{}
+            , positions{}, freeSlots{}
+            , compare{compare}
+        {
+        }
+
+        handle push(const key_type& key)
+        {
+            return emplace(key);
+        }
+
+        handle push(key_type&& key)
+        {
+            return emplace(std::move(key));
+        }
+
+        template<typename... Args>
+        handle emplace(Args&&... args)
+        {
+            handle slot{acquire_slot()};
+            keys.emplace_back(std::forward<Args>(args)...);
+            slots.push_back(slot);
+            positions[slot] = slots.size() - 1;
+            sift_up(slots.size() - 1);
+            return slot;
+        }
+
+        const_reference top() const
+        {
+            if(empty())
+            {
+                throw std::out_of_range{"Error: top of an empty heap."};
+            }
+            return keys[padding];
+        }
+
+        void pop()
+        {
+            if(empty())
+            {
+                throw std::out_of_range{"Error: pop of an empty heap."};
+            }
+            remove_at(0);
+        }
+
+        void decrease_key(handle slot, const key_type& key)
+        {
+            size_type position{positions[slot]};
+            if(compare(key_at(position), key))
+            {
+                throw std::invalid_argument{"Error: new key is worse than the current one."};
+            }
+            key_at(position) = key;
+            sift_up(position);
+        }
+
+        void erase(handle slot)
+        {
+            remove_at(positions[slot]);
+        }
+
+        const_reference key(handle slot) const
+        {
+            return key_at(positions[slot]);
+        }
+
+        size_type size() const noexcept
+        {
+            return slots.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return slots.empty();
+        }
+
+        void reserve(size_type capacity)
+        {
+            keys.reserve(capacity + padding);
+            slots.reserve(capacity);
+            positions.reserve(capacity);
+        }
+
+        void clear()
+        {
+            keys.resize(padding);
+            slots.clear();
+            positions.clear();
+            freeSlots.clear();
+        }
+    private:
+        static constexpr size_type padding{Arity - 1};
+        static constexpr size_type released{std::numeric_limits<size_type>::max()};
+
+        key_type& key_at(size_type position) noexcept
+        {
+            return keys[position + padding];
+        }
+
+        const key_type& key_at(size_type position) const noexcept
+        {
+            return keys[position + padding];
+        }
+
+        handle acquire_slot()
+        {
+            if(freeSlots.empty())
+            {
+                positions.push_back(released);
+                return positions.size() - 1;
+            }
+            handle slot{freeSlots.back()};
+            freeSlots.pop_back();
+            return slot;
+        }
+
+        void place(size_type position, key_type&& key, handle slot) noexcept
+        {
+            key_at(position) = std::move(key);
+            slots[position] = slot;
+            positions[slot] = position;
+        }
+
+        void remove_at(size_type position)
+        {
+            handle removed{slots[position]};
+            size_type last{slots.size() - 1};
+            if(position != last)
+            {
+                key_type moved{std::move(key_at(last))};
+                handle movedSlot{slots[last]};
+                keys.pop_back();
+                slots.pop_back();
+                bool rises{compare(moved, key_at(position))};
+                place(position, std::move(moved), movedSlot);
+                rises? sift_up(position) : sift_down(position);
+            }
+            else
+            {
+                keys.pop_back();
+                slots.pop_back();
+            }
+            positions[removed] = released;
+            freeSlots.push_back(removed);
+        }
+
+        void sift_up(size_type position)
+        {
+            key_type moving{std::move(key_at(position))};
+            handle slot{slots[position]};
+            while(position > 0)
+            {
+                size_type parent{(position - 1) / Arity};
+                if(!compare(moving, key_at(parent)))
+                {
+                    break;
+                }
+                place(position, std::move(key_at(parent)), slots[parent]);
+                position = parent;
+            }
+            place(position, std::move(moving), slot);
+        }
+
+        void sift_down(size_type position)
+        {
+            key_type moving{std::move(key_at(position))};
+            handle slot{slots[position]};
+            size_type count{slots.size()};
+            while(true)
+            {
+                size_type first{position * Arity + 1};
+                if(first >= count)
+                {
+                    break;
+                }
+                size_type end{first + Arity < count? first + Arity : count};
+                size_type best{first};
+                for(size_type child{first + 1}; child < end; ++child)
+                {
+                    if(compare(key_at(child), key_at(best)))
+                    {
+                        best = child;
+                    }
+                }
+                if(!compare(key_at(best), moving))
+                {
+                    break;
+                }
+                place(position, std::move(key_at(best)), slots[best]);
+                position = best;
+            }
+            place(position, std::move(moving), slot);
+        }
+
+        std::vector<key_type, CacheAlignedAllocator<key_type>> keys;
+        std::vector<handle> slots;
+        std::vector<size_type> positions;
+        std::vector<handle> freeSlots;
+        key_compare compare;
+    };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <stdexcept>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
 #include <iterator>
 #include <iostream>
@@ -156,7 +157,7 @@ namespace algo
         using reference         = value_type&;
 
         constexpr DynamicMatrixIterator() noexcept 
-            : pos{pos}
+            : pos{nullptr}
         {
         }
 
@@ -296,55 +297,92 @@ namespace algo
 
         constexpr DynamicMatrix()
             : rowsNumber{0}, colsNumber{0}
-            , memory{}, storage{std::allocator_traits<allocator_type>::allocate(memory, 0)}
+            , memory{}, storage{nullptr}
         {
         }
 
-        constexpr DynamicMatrix(const size_type order)
+        constexpr explicit DynamicMatrix(const allocator_type& memory)
+            : rowsNumber{0}, colsNumber{0}
+            , memory{memory}, storage{nullptr}
+        {
+        }
+
+        constexpr DynamicMatrix(const size_type order, const allocator_type& memory = allocator_type{})
             : rowsNumber{order}, colsNumber{order}
-            , memory{}, storage{std::allocator_traits<allocator_type>::allocate(memory, rows() * cols())}
+            , memory{memory}, storage{allocate(rows() * cols())}
         {
-            initialize_default(storage);
+            initialize_default(storage, size());
         }
 
-        constexpr DynamicMatrix(const size_type rowsNumber, const size_type colsNumber)
+        constexpr DynamicMatrix(const size_type rowsNumber, const size_type colsNumber, const allocator_type& memory = allocator_type{})
             : rowsNumber{rowsNumber}, colsNumber{colsNumber}
-            , memory{}, storage{std::allocator_traits<allocator_type>::allocate(memory, rows() * cols())}
+            , memory{memory}, storage{allocate(rows() * cols())}
         {
-            initialize_default(storage);
+            initialize_default(storage, size());
         }
 
         constexpr DynamicMatrix(const DynamicMatrix& that)
+            : DynamicMatrix{that, alloc_traits::select_on_container_copy_construction(that.memory)}
+        {
+        }
+
+        constexpr DynamicMatrix(const DynamicMatrix& that, const allocator_type& memory)
             : rowsNumber{that.rowsNumber}, colsNumber{that.colsNumber}
-            , memory{that.memory}, storage{std::allocator_traits<allocator_type>::allocate(memory, rows() * cols())}
+            , memory{memory}, storage{allocate(rows() * cols())}
         {
-            for(std::size_t row{0}; row < rows(); ++row)
+            for(size_type index{0}; index < size(); ++index)
             {
-                for(std::size_t col{0}; col < cols(); ++col)
-                {
-                    std::allocator_traits<allocator_type>::construct(memory, storage + row * rows() + col, std::move(that.storage[row + col * cols()]));
-                }
+                alloc_traits::construct(this->memory, storage + index, that.storage[index]);
             }
         }
 
-        constexpr reference operator=(const DynamicMatrix& that)
+        constexpr DynamicMatrix& operator=(const DynamicMatrix& that)
         {
-            DynamicMatrix{that}.swap(*this);
+            if(this != &that)
+            {
+                DynamicMatrix copy{that, alloc_traits::propagate_on_container_copy_assignment::value? that.memory : memory};
+                adopt<typename alloc_traits::propagate_on_container_copy_assignment>(copy);
+            }
             return *this;
         }
 
-        constexpr DynamicMatrix(DynamicMatrix&& that)
+        constexpr DynamicMatrix(DynamicMatrix&& that) noexcept
             : rowsNumber{that.rowsNumber}, colsNumber{that.colsNumber}
-            , memory{that.memory}, storage{that.storage}
+            , memory{std::move(that.memory)}, storage{that.storage}
         {
             that.rowsNumber = 0;
             that.colsNumber = 0;
-            that.storage = std::allocator_traits<allocator_type>::allocate(memory, 0);
+            that.storage = nullptr;
+        }
+
+        // Takes over the storage when memory can free it, otherwise moves element by element.
+        constexpr DynamicMatrix(DynamicMatrix&& that, const allocator_type& memory)
+            : rowsNumber{0}, colsNumber{0}
+            , memory{memory}, storage{nullptr}
+        {
+            if(this->memory == that.memory)
+            {
+                swap_contents(that);
+                return;
+            }
+            storage = allocate(that.rows() * that.cols());
+            for(size_type index{0}; index < that.rows() * that.cols(); ++index)
+            {
+                alloc_traits::construct(this->memory, storage + index, std::move(that.storage[index]));
+            }
+            rowsNumber = that.rowsNumber;
+            colsNumber = that.colsNumber;
+            that.clear();
         }
 
-        constexpr reference operator=(DynamicMatrix&& that)
+        constexpr DynamicMatrix& operator=(DynamicMatrix&& that) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                                                          || alloc_traits::is_always_equal::value)
         {
-            DynamicMatrix{std::move(that)}.swap(*this);
+            if(this != &that)
+            {
+                DynamicMatrix moved{std::move(that), alloc_traits::propagate_on_container_move_assignment::value? that.memory : memory};
+                adopt<typename alloc_traits::propagate_on_container_move_assignment>(moved);
+            }
             return *this;
         }
 
@@ -353,6 +391,11 @@ namespace algo
             clear();
         }
 
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return memory;
+        }
+
         constexpr size_type rows() const noexcept
         {
             return rowsNumber;
@@ -363,6 +406,11 @@ namespace algo
             return colsNumber;
         }
 
+        constexpr size_type size() const noexcept
+        {
+            return rowsNumber * colsNumber;
+        }
+
         constexpr reference operator[](const size_type row, const size_type col)
         {
             if(row >= rows())
@@ -373,7 +421,7 @@ namespace algo
             {
                 throw std::out_of_range{"Error: wrong col number."};
             }
-            return storage[row * rows() + col] ;
+            return storage[row * cols() + col];
         }
         
         constexpr const_reference operator[](const size_type row, const size_type col) const
@@ -386,7 +434,7 @@ namespace algo
             {
                 throw std::out_of_range{"Error: wrong col number."};
             }
-            return storage[row * rows() + col];
+            return storage[row * cols() + col];
         }
 
         constexpr reference at(const size_type row, const size_type col)
@@ -401,12 +449,12 @@ namespace algo
 
         constexpr pointer data() noexcept
         {
-            return data;
+            return storage;
         }
 
         constexpr const_pointer data() const noexcept
         {
-            return data;
+            return storage;
         }
 
         constexpr iterator begin() noexcept
@@ -426,17 +474,17 @@ namespace algo
         
         constexpr reverse_iterator rbegin() noexcept
         {
-            return reverse_iterator{storage};
+            return reverse_iterator{end()};
         }
         
         constexpr const_reverse_iterator rbegin() const noexcept
         {
-            return const_reverse_iterator{storage};
+            return const_reverse_iterator{end()};
         }
         
         constexpr const_reverse_iterator crbegin() const noexcept
         {
-            return const_reverse_iterator{storage};
+            return const_reverse_iterator{cend()};
         }
         
         constexpr iterator end() noexcept
@@ -456,81 +504,108 @@ namespace algo
         
         constexpr reverse_iterator rend() noexcept
         {
-            return reverse_iterator{storage + rows() * cols()};
+            return reverse_iterator{begin()};
         }
         
         constexpr const_reverse_iterator rend() const noexcept
         {
-            return const_reverse_iterator{storage + rows() * cols()};
+            return const_reverse_iterator{begin()};
         }
         
         constexpr const_reverse_iterator crend() const noexcept
         {
-            return const_reverse_iterator{storage + rows() * cols()};
+            return const_reverse_iterator{cbegin()};
         }
 
         constexpr void resize(const size_type freshRows, const size_type freshCols, bool preserve = true)
         {
-            pointer freshStorage{std::allocator_traits<allocator_type>::allocate(memory, freshRows * freshCols)};
+            pointer freshStorage{allocate(freshRows * freshCols)};
             if(preserve)
             {
                 copy_to_fresh_memory(freshStorage, freshRows, freshCols);
-                clear();
             }
             else
             {
-                clear();
-                initialize_default(freshStorage);
+                initialize_default(freshStorage, freshRows * freshCols);
             }
+            clear();
             rowsNumber = freshRows;
             colsNumber = freshCols;
             storage = freshStorage;
         }
 
-        constexpr void swap(DynamicMatrix& that)
+        // Allocators that do not propagate on swap must compare equal.
+        constexpr void swap(DynamicMatrix& that) noexcept
         {
-            std::swap(this->rowsNumber, that.rowsNumber);
-            std::swap(this->colsNumber, that.colsNumber);
-            std::swap(this->memory, that.memory);
-            std::swap(this->storage, that.storage);
+            adopt<typename alloc_traits::propagate_on_container_swap>(that);
         }
 
         constexpr void clear()
         {
-            for(size_type row{0}; row < rows(); ++row)
+            for(size_type index{0}; index < size(); ++index)
             {
-                for(size_type col{0}; col < cols(); ++col)
-                {
-                    std::allocator_traits<allocator_type>::destroy(memory, storage + row * rows() + col);
-                }
+                alloc_traits::destroy(memory, storage + index);
+            }
+            if(storage)
+            {
+                alloc_traits::deallocate(memory, storage, size());
             }
-            std::allocator_traits<allocator_type>::deallocate(memory, storage, rows() * cols());
             rowsNumber = 0;
             colsNumber = 0;
-            storage = std::allocator_traits<Allocator>::allocate(memory, 0);
+            storage = nullptr;
         }
     private:
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        // Empty matrices hold no storage, so they never touch the allocator.
+        constexpr pointer allocate(const size_type count)
+        {
+            return count == 0? nullptr : alloc_traits::allocate(memory, count);
+        }
+
+        constexpr void swap_contents(DynamicMatrix& that) noexcept
+        {
+            std::swap(this->rowsNumber, that.rowsNumber);
+            std::swap(this->colsNumber, that.colsNumber);
+            std::swap(this->storage, that.storage);
+        }
+
+        // Assignments build the replacement with the allocator this matrix must end up
+        // with, so when Propagate is false the allocators are already equal.
+        template<typename Propagate>
+        constexpr void adopt(DynamicMatrix& that) noexcept
+        {
+            swap_contents(that);
+            if constexpr(Propagate::value)
+            {
+                std::swap(this->memory, that.memory);
+            }
+        }
+
+        // Moves the overlapping block into place and default-constructs the rest.
         constexpr void copy_to_fresh_memory(pointer freshStorage, const size_type freshRows, const size_type freshCols)
         {
-            size_type minRows{std::min(rows(), freshRows)};
-            size_type minCols{std::min(cols(), freshCols)};
-            for(size_type row{0}; row < minRows; ++row)
+            for(size_type row{0}; row < freshRows; ++row)
             {
-                for(size_type col{0}; col < minCols; ++col)
+                for(size_type col{0}; col < freshCols; ++col)
                 {
-                    std::allocator_traits<allocator_type>::construct(memory, freshStorage + row * minRows + col, std::move(storage[row * minRows + col]));
+                    if(row < rows() && col < cols())
+                    {
+                        alloc_traits::construct(memory, freshStorage + row * freshCols + col, std::move(storage[row * cols() + col]));
+                    }
+                    else
+                    {
+                        alloc_traits::construct(memory, freshStorage + row * freshCols + col);
+                    }
                 }
             }
         }
 
-        constexpr void initialize_default(pointer storage, value_type default_value = value_type{})
+        constexpr void initialize_default(pointer storage, const size_type count)
         {
-            for(size_type row{0}; row < rows(); ++row)
+            for(size_type index{0}; index < count; ++index)
             {
-                for(size_type col{0}; col < cols(); ++col)
-                {
-                    std::allocator_traits<allocator_type>::construct(memory, storage + row * rows() + col, default_value);
-                }
+                alloc_traits::construct(memory, storage + index);
             }
         }
 
@@ -539,6 +614,12 @@ namespace algo
         allocator_type memory;
         pointer storage;
     };
+
+    namespace pmr
+    {
+        template<typename Type>
+        using DynamicMatrix = algo::DynamicMatrix<Type, std::pmr::polymorphic_allocator<Type>>;
+    }
 }
 
 #endif
\ No newline at end of file
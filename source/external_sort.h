@@ -0,0 +1,492 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <ios>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "fibonacci_heap.h"
+#include "scratch_directory.h"
+
+namespace algo
+{
+    // Tournament tree over a fixed set of sources. Every inner node keeps the source that
+    // lost the match played there and slot 0 keeps the overall winner, so replacing the
+    // winner's key replays one leaf-to-root path of log2(k) comparisons, each against a
+    // stored loser, with no sibling lookups. Exhausted sources lose to everything; ties
+    // go to the lower source index, which keeps merges of ordered runs stable.
+    template<typename Key,
+             typename Compare = std::less<Key>>
+    class LoserTree
+    {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+
+        // Sources without an initial key start out exhausted.
+        explicit LoserTree(const std::vector<std::optional<Key>>& initial, const Compare& compare = Compare{})
+            : leaves{std::bit_ceil(std::max<size_type>(1, initial.size()))}
+            , tree(leaves), keys(leaves)
+            , active(leaves, false), compare{compare}
+        {
+            for(size_type source{0}; source < initial.size(); ++source)
+            {
+                if(initial[source])
+                {
+                    keys[source] = *initial[source];
+                    active[source] = true;
+                }
+            }
+            std::vector<size_type> winners(2 * leaves);
+            for(size_type source{0}; source < leaves; ++source)
+            {
+                winners[leaves + source] = source;
+            }
+            for(size_type node{leaves - 1}; node > 0; --node)
+            {
+                const size_type left{winners[2 * node]};
+                const size_type right{winners[2 * node + 1]};
+                const bool leftWins{beats(left, right)};
+                winners[node] = leftWins? left : right;
+                tree[node] = leftWins? right : left;
+            }
+            tree[0] = winners[1];
+        }
+
+        bool empty() const noexcept
+        {
+            return !active[tree[0]];
+        }
+
+        const key_type& top() const noexcept
+        {
+            return keys[tree[0]];
+        }
+
+        size_type top_source() const noexcept
+        {
+            return tree[0];
+        }
+
+        // Gives the winning source its next key.
+        void replace_top(const key_type& key)
+        {
+            keys[tree[0]] = key;
+            replay(tree[0]);
+        }
+
+        // Marks the winning source as exhausted.
+        void pop()
+        {
+            active[tree[0]] = false;
+            replay(tree[0]);
+        }
+    private:
+        bool beats(const size_type lhs, const size_type rhs) const
+        {
+            if(!active[lhs]
+               || !active[rhs])
+            {
+                return active[lhs] || (!active[rhs] && lhs < rhs);
+            }
+            if(compare(keys[lhs], keys[rhs]))
+            {
+                return true;
+            }
+            return !compare(keys[rhs], keys[lhs]) && lhs < rhs;
+        }
+
+        void replay(size_type candidate)
+        {
+            for(size_type node{(leaves + candidate) / 2}; node > 0; node /= 2)
+            {
+                if(beats(tree[node], candidate))
+                {
+                    std::swap(tree[node], candidate);
+                }
+            }
+            tree[0] = candidate;
+        }
+
+        size_type leaves;
+        std::vector<size_type> tree;
+        std::vector<Key> keys;
+        std::vector<bool> active;
+        Compare compare;
+    };
+
+    // The same merge interface as LoserTree on top of a heap of (key, source) entries.
+    // Each step is a pop and a push, as the heaps here only support decreasing keys.
+    template<typename Key,
+             typename Compare,
+             template<typename, typename> class Heap>
+    class HeapMerger
+    {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+
+        explicit HeapMerger(const std::vector<std::optional<Key>>& initial, const Compare& compare = Compare{})
+            : heap{EntryCompare{compare}}
+        {
+            for(size_type source{0}; source < initial.size(); ++source)
+            {
+                if(initial[source])
+                {
+                    heap.push(Entry{*initial[source], source});
+                }
+            }
+        }
+
+        bool empty() const
+        {
+            return heap.empty();
+        }
+
+        const key_type& top() const
+        {
+            return heap.top().key;
+        }
+
+        size_type top_source() const
+        {
+            return heap.top().source;
+        }
+
+        void replace_top(const key_type& key)
+        {
+            const size_type source{heap.top().source};
+            heap.pop();
+            heap.push(Entry{key, source});
+        }
+
+        void pop()
+        {
+            heap.pop();
+        }
+    private:
+        struct Entry
+        {
+            Key key;
+            size_type source;
+        };
+
+        struct EntryCompare
+        {
+            bool operator()(const Entry& lhs, const Entry& rhs) const
+            {
+                if(compare(lhs.key, rhs.key))
+                {
+                    return true;
+                }
+                return !compare(rhs.key, lhs.key) && lhs.source < rhs.source;
+            }
+
+            Compare compare;
+        };
+
+        Heap<Entry, EntryCompare> heap;
+    };
+
+    template<typename Key, typename Compare>
+    using FibonacciMerger = HeapMerger<Key, Compare, fibonacci_heap>;
+
+    // Reads a file of raw Type values through a buffer of bufferSize elements, so the
+    // stream sees only large sequential reads.
+    template<typename Type>
+    class RunReader
+    {
+    public:
+        RunReader(const std::filesystem::path& path, const std::size_t bufferSize)
+            : stream{path, std::ios::binary}, buffer(std::max<std::size_t>(1, bufferSize))
+            , position{0}, filled{0}
+            , bytesRead{0}
+        {
+            if(!stream)
+            {
+                throw std::runtime_error{"Error: cannot open " + path.string()};
+            }
+        }
+
+        bool read(Type& value)
+        {
+            if(position == filled
+               && !refill())
+            {
+                return false;
+            }
+            value = buffer[position++];
+            return true;
+        }
+
+        std::size_t bytes_read() const noexcept
+        {
+            return bytesRead;
+        }
+    private:
+        bool refill()
+        {
+            stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Type)));
+            const auto bytes{static_cast<std::size_t>(stream.gcount())};
+            if(stream.bad())
+            {
+                throw std::runtime_error{"Error: read failed."};
+            }
+            bytesRead += bytes;
+            position = 0;
+            filled = bytes / sizeof(Type);
+            return filled > 0;
+        }
+
+        std::ifstream stream;
+        std::vector<Type> buffer;
+        std::size_t position;
+        std::size_t filled;
+        std::size_t bytesRead;
+    };
+
+    template<typename Type>
+    class RunWriter
+    {
+    public:
+        RunWriter(const std::filesystem::path& path, const std::size_t bufferSize)
+            : stream{path, std::ios::binary | std::ios::trunc}, buffer{}
+            , capacity{std::max<std::size_t>(1, bufferSize)}, bytesWritten{0}
+        {
+            if(!stream)
+            {
+                throw std::runtime_error{"Error: cannot create " + path.string()};
+            }
+            buffer.reserve(capacity);
+        }
+
+        void write(const Type& value)
+        {
+            buffer.push_back(value);
+            if(buffer.size() == capacity)
+            {
+                flush();
+            }
+        }
+
+        void write(const Type* values, const std::size_t count)
+        {
+            flush();
+            write_bytes(values, count);
+        }
+
+        void flush()
+        {
+            write_bytes(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+        std::size_t bytes_written() const noexcept
+        {
+            return bytesWritten;
+        }
+    private:
+        void write_bytes(const Type* values, const std::size_t count)
+        {
+            stream.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(Type)));
+            if(!stream)
+            {
+                throw std::runtime_error{"Error: write failed."};
+            }
+            bytesWritten += count * sizeof(Type);
+        }
+
+        std::ofstream stream;
+        std::vector<Type> buffer;
+        std::size_t capacity;
+        std::size_t bytesWritten;
+    };
+
+    struct ExternalSortOptions
+    {
+        // Memory for run generation, split evenly between the threads; each run is one
+        // thread's share, sorted in memory.
+        std::size_t memoryBudget{std::size_t{64} << 20};
+        // Buffer for each run read and for the output during merging.
+        std::size_t ioBufferSize{std::size_t{1} << 20};
+        // Runs merged at once; 0 picks as many as the budget has buffers for.
+        std::size_t fanIn{0};
+        std::size_t threads{1};
+        std::filesystem::path temporaryDirectory{std::filesystem::temp_directory_path()};
+    };
+
+    struct ExternalSortStats
+    {
+        std::size_t runs{0};
+        std::size_t mergePasses{0};
+        std::size_t bytesRead{0};
+        std::size_t bytesWritten{0};
+        double runSeconds{0};
+        double mergeSeconds{0};
+    };
+
+    // Sorts a file of raw Type values into output. Run generation fills a buffer from
+    // the input, sorts it and writes it out as a run; with several threads each one
+    // does this with its own buffer, taking turns only to read. Runs are then merged
+    // fanIn at a time through Merger (LoserTree or a HeapMerger), in as many passes as
+    // it takes to get down to fanIn runs, and a last pass writes the output.
+    template<typename Type,
+             typename Compare = std::less<Type>,
+             template<typename, typename> class Merger = LoserTree>
+    ExternalSortStats external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+                                    const ExternalSortOptions& options = ExternalSortOptions{}, const Compare& compare = Compare{})
+    {
+        static_assert(std::is_trivially_copyable_v<Type>, "Values are read and written as raw bytes.");
+        using clock = std::chrono::steady_clock;
+        const auto seconds_since{[](const clock::time_point start)
+        {
+            return std::chrono::duration<double>(clock::now() - start).count();
+        }};
+        if(std::filesystem::file_size(input) % sizeof(Type) != 0)
+        {
+            throw std::invalid_argument{"Error: input size is not a multiple of the value size."};
+        }
+        const std::size_t threads{std::max<std::size_t>(1, options.threads)};
+        const std::size_t runSize{std::max<std::size_t>(1, options.memoryBudget / sizeof(Type) / threads)};
+        const std::size_t bufferSize{std::max<std::size_t>(1, options.ioBufferSize / sizeof(Type))};
+        const std::size_t buffers{options.memoryBudget / std::max<std::size_t>(1, options.ioBufferSize)};
+        const std::size_t fanIn{std::max<std::size_t>(2, options.fanIn? options.fanIn : buffers > 0? buffers - 1 : 0)};
+
+        // Runs live in a directory of their own, removed however the sort ends.
+        const ScratchDirectory scratch{options.temporaryDirectory, "external_sort_"};
+        std::size_t runNumber{0};
+        const auto fresh_run{[&]
+        {
+            return scratch.path() / ("run_" + std::to_string(runNumber++));
+        }};
+
+        ExternalSortStats stats{};
+        const auto generating{clock::now()};
+        std::vector<std::filesystem::path> runs;
+        {
+            std::ifstream source{input, std::ios::binary};
+            if(!source)
+            {
+                throw std::runtime_error{"Error: cannot open " + input.string()};
+            }
+            std::mutex reading;
+            const auto generate{[&]
+            {
+                std::vector<Type> buffer(runSize);
+                std::size_t written{0};
+                while(true)
+                {
+                    std::size_t count{0};
+                    std::filesystem::path run;
+                    {
+                        std::lock_guard<std::mutex> lock{reading};
+                        source.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(runSize * sizeof(Type)));
+                        if(source.bad())
+                        {
+                            throw std::runtime_error{"Error: read failed."};
+                        }
+                        count = static_cast<std::size_t>(source.gcount()) / sizeof(Type);
+                        if(count == 0)
+                        {
+                            break;
+                        }
+                        run = fresh_run();
+                        runs.push_back(run);
+                    }
+                    std::sort(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(count), compare);
+                    RunWriter<Type> writer{run, bufferSize};
+                    writer.write(buffer.data(), count);
+                    written += writer.bytes_written();
+                }
+                return written;
+            }};
+            std::vector<std::future<std::size_t>> workers;
+            for(std::size_t worker{1}; worker < threads; ++worker)
+            {
+                workers.push_back(std::async(std::launch::async, generate));
+            }
+            stats.bytesWritten += generate();
+            for(auto& worker : workers)
+            {
+                stats.bytesWritten += worker.get();
+            }
+        }
+        stats.bytesRead += std::filesystem::file_size(input);
+        stats.runs = runs.size();
+        stats.runSeconds = seconds_since(generating);
+
+        const auto merging{clock::now()};
+        const auto merge{[&](const std::vector<std::filesystem::path>& sources, const std::filesystem::path& target)
+        {
+            std::vector<RunReader<Type>> readers;
+            readers.reserve(sources.size());
+            std::vector<std::optional<Type>> initial(sources.size());
+            for(std::size_t index{0}; index < sources.size(); ++index)
+            {
+                readers.emplace_back(sources[index], bufferSize);
+                Type value;
+                if(readers[index].read(value))
+                {
+                    initial[index] = value;
+                }
+            }
+            Merger<Type, Compare> merger{initial, compare};
+            RunWriter<Type> writer{target, bufferSize};
+            Type value;
+            while(!merger.empty())
+            {
+                writer.write(merger.top());
+                if(readers[merger.top_source()].read(value))
+                {
+                    merger.replace_top(value);
+                }
+                else
+                {
+                    merger.pop();
+                }
+            }
+            writer.flush();
+            for(const auto& reader : readers)
+            {
+                stats.bytesRead += reader.bytes_read();
+            }
+            stats.bytesWritten += writer.bytes_written();
+        }};
+        while(runs.size() > fanIn)
+        {
+            std::vector<std::filesystem::path> merged;
+            for(std::size_t start{0}; start < runs.size(); start += fanIn)
+            {
+                const std::vector<std::filesystem::path> group(runs.begin() + static_cast<std::ptrdiff_t>(start),
+                                                               runs.begin() + static_cast<std::ptrdiff_t>(std::min(runs.size(), start + fanIn)));
+                merged.push_back(fresh_run());
+                merge(group, merged.back());
+                for(const auto& run : group)
+                {
+                    std::filesystem::remove(run);
+                }
+            }
+            runs = std::move(merged);
+            ++stats.mergePasses;
+        }
+        merge(runs, output);
+        ++stats.mergePasses;
+        stats.mergeSeconds = seconds_since(merging);
+        return stats;
+    }
+}
+
+#endif
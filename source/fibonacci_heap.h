@@ -1,14 +1,399 @@
 #ifndef FIBONACCI_HEAP
 #define FIBONACCI_HEAP
 
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "addressable_heap.h"
+#include "node_pool.h"
+
 namespace algo
 {
+    template<typename Key>
+    struct FibonacciHeapNode
+    {
+        template<typename... Args>
+        explicit FibonacciHeapNode(Args&&... args)
+            : parent{nullptr}, child{nullptr}
+            , left{this}, right{this}
+            , degree{0}, marked{false}
+            , key(std::forward<Args>(args)...)
+        {
+        }
+
+        FibonacciHeapNode* parent;
+        FibonacciHeapNode* child;
+        FibonacciHeapNode* left;
+        FibonacciHeapNode* right;
+        std::uint32_t degree;
+        bool marked;
+        Key key;
+    };
+
+    // top() is the key no other key compares less than, so std::less gives a min-heap.
+    // Handles are node pointers that stay valid until their key is popped or erased,
+    // including after the heap they live in is merged into another one.
+    template<typename Key,
+             typename Compare = std::less<Key>>
     class fibonacci_heap
     {
     public:
-        
+        using key_type = Key;
+        using value_type = Key;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using node_type = FibonacciHeapNode<Key>;
+        using handle = node_type*;
+        using const_reference = const key_type&;
+
+        fibonacci_heap()
+            : minimum{nullptr}, count{0}
+            , pool{}, degreeTable{}
+            , compare{}
+        {
+        }
+
+        explicit fibonacci_heap(const key_compare& compare)
+            : minimum{nullptr}, count{0}
+            , pool{}, degreeTable{}
+            , compare{compare}
+        {
+        }
+
+        fibonacci_heap(const fibonacci_heap&) = delete;
+        fibonacci_heap& operator=(const fibonacci_heap&) = delete;
+
+        fibonacci_heap(fibonacci_heap&& that) noexcept
+            : minimum{that.minimum}, count{that.count}
+            , pool{std::move(that.pool)}, degreeTable{std::move(that.degreeTable)}
+            , compare{std::move(that.compare)}
+        {
+            that.minimum = nullptr;
+            that.count = 0;
+        }
+
+        fibonacci_heap& operator=(fibonacci_heap&& that) noexcept
+        {
+            fibonacci_heap{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        ~fibonacci_heap()
+        {
+            clear();
+        }
+
+        template<typename... Args>
+        handle emplace(Args&&... args)
+        {
+            node_type* fresh{pool.create(std::forward<Args>(args)...)};
+            add_root(fresh);
+            ++count;
+            return fresh;
+        }
+
+        handle push(const key_type& key)
+        {
+            return emplace(key);
+        }
+
+        handle push(key_type&& key)
+        {
+            return emplace(std::move(key));
+        }
+
+        const_reference top() const
+        {
+            if(minimum == nullptr)
+            {
+                throw std::out_of_range{"Error: top of an empty heap."};
+            }
+            return minimum->key;
+        }
+
+        void pop()
+        {
+            if(minimum == nullptr)
+            {
+                throw std::out_of_range{"Error: pop of an empty heap."};
+            }
+            node_type* removed{minimum};
+            promote_children(removed);
+            if(removed->right == removed)
+            {
+                minimum = nullptr;
+            }
+            else
+            {
+                minimum = removed->right;
+                unlink(removed);
+                consolidate();
+            }
+            --count;
+            pool.destroy(removed);
+        }
+
+        void decrease_key(handle node, const key_type& key)
+        {
+            if(compare(node->key, key))
+            {
+                throw std::invalid_argument{"Error: new key is worse than the current one."};
+            }
+            node->key = key;
+            node_type* parent{node->parent};
+            if(parent
+               && compare(node->key, parent->key))
+            {
+                cut(node, parent);
+                cascading_cut(parent);
+            }
+            if(compare(node->key, minimum->key))
+            {
+                minimum = node;
+            }
+        }
+
+        void erase(handle node)
+        {
+            if(node_type* parent{node->parent})
+            {
+                cut(node, parent);
+                cascading_cut(parent);
+            }
+            minimum = node;
+            pop();
+        }
+
+        // Handles from that stay valid and now refer to entries of this heap.
+        void merge(fibonacci_heap& that)
+        {
+            if(this == &that
+               || that.minimum == nullptr)
+            {
+                return;
+            }
+            pool.splice(that.pool);
+            if(minimum == nullptr)
+            {
+                minimum = that.minimum;
+            }
+            else
+            {
+                node_type* thisNext{minimum->right};
+                node_type* thatPrevious{that.minimum->left};
+                minimum->right = that.minimum;
+                that.minimum->left = minimum;
+                thatPrevious->right = thisNext;
+                thisNext->left = thatPrevious;
+                if(compare(that.minimum->key, minimum->key))
+                {
+                    minimum = that.minimum;
+                }
+            }
+            count += that.count;
+            that.minimum = nullptr;
+            that.count = 0;
+        }
+
+        void merge(fibonacci_heap&& that)
+        {
+            merge(that);
+        }
+
+        size_type size() const noexcept
+        {
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        void clear()
+        {
+            if(minimum)
+            {
+                destroy_list(minimum);
+            }
+            minimum = nullptr;
+            count = 0;
+        }
+
+        void swap(fibonacci_heap& that) noexcept
+        {
+            std::swap(this->minimum, that.minimum);
+            std::swap(this->count, that.count);
+            this->pool.swap(that.pool);
+            std::swap(this->degreeTable, that.degreeTable);
+            std::swap(this->compare, that.compare);
+        }
     private:
-        
+        static void splice_after(node_type* position, node_type* node) noexcept
+        {
+            node->left = position;
+            node->right = position->right;
+            position->right->left = node;
+            position->right = node;
+        }
+
+        static void unlink(node_type* node) noexcept
+        {
+            node->left->right = node->right;
+            node->right->left = node->left;
+            node->left = node;
+            node->right = node;
+        }
+
+        void add_root(node_type* node) noexcept
+        {
+            node->parent = nullptr;
+            node->marked = false;
+            if(minimum == nullptr)
+            {
+                node->left = node;
+                node->right = node;
+                minimum = node;
+                return;
+            }
+            splice_after(minimum, node);
+            if(compare(node->key, minimum->key))
+            {
+                minimum = node;
+            }
+        }
+
+        void promote_children(node_type* node) noexcept
+        {
+            node_type* child{node->child};
+            for(std::uint32_t index{0}; index < node->degree; ++index)
+            {
+                node_type* next{child->right};
+                child->parent = nullptr;
+                child->marked = false;
+                child->left = child;
+                child->right = child;
+                splice_after(node, child);
+                child = next;
+            }
+            node->child = nullptr;
+            node->degree = 0;
+        }
+
+        void make_child(node_type* child, node_type* parent) noexcept
+        {
+            unlink(child);
+            child->parent = parent;
+            child->marked = false;
+            if(parent->child == nullptr)
+            {
+                parent->child = child;
+            }
+            else
+            {
+                splice_after(parent->child, child);
+            }
+            ++parent->degree;
+        }
+
+        // The degree table only grows, so steady-state pops never allocate.
+        void consolidate()
+        {
+            size_type bound{static_cast<size_type>(std::bit_width(count)) * 3 / 2 + 2};
+            if(degreeTable.size() < bound)
+            {
+                degreeTable.resize(bound, nullptr);
+            }
+            size_type roots{1};
+            for(node_type* position{minimum->right}; position != minimum; position = position->right)
+            {
+                ++roots;
+            }
+            node_type* current{minimum};
+            for(; roots > 0; --roots)
+            {
+                node_type* next{current->right};
+                node_type* tree{current};
+                std::uint32_t degree{tree->degree};
+                while(degreeTable[degree])
+                {
+                    node_type* other{degreeTable[degree]};
+                    if(compare(other->key, tree->key))
+                    {
+                        std::swap(tree, other);
+                    }
+                    make_child(other, tree);
+                    degreeTable[degree] = nullptr;
+                    ++degree;
+                }
+                degreeTable[degree] = tree;
+                current = next;
+            }
+            minimum = nullptr;
+            for(auto& slot : degreeTable)
+            {
+                if(slot
+                   && (minimum == nullptr || compare(slot->key, minimum->key)))
+                {
+                    minimum = slot;
+                }
+                slot = nullptr;
+            }
+        }
+
+        void cut(node_type* node, node_type* parent) noexcept
+        {
+            if(parent->child == node)
+            {
+                parent->child = node->right == node? nullptr : node->right;
+            }
+            --parent->degree;
+            unlink(node);
+            add_root(node);
+        }
+
+        void cascading_cut(node_type* node) noexcept
+        {
+            while(node_type* parent{node->parent})
+            {
+                if(!node->marked)
+                {
+                    node->marked = true;
+                    return;
+                }
+                cut(node, parent);
+                node = parent;
+            }
+        }
+
+        // The ring is opened into a right-linked list, and each node's children are
+        // spliced in behind it before it is freed, so arbitrarily deep trees are freed
+        // without recursion.
+        void destroy_list(node_type* first)
+        {
+            first->left->right = nullptr;
+            node_type* node{first};
+            while(node)
+            {
+                if(node_type* child{node->child})
+                {
+                    child->left->right = node->right;
+                    node->right = child;
+                }
+                node_type* next{node->right};
+                pool.destroy(node);
+                node = next;
+            }
+        }
+
+        node_type* minimum;
+        size_type count;
+        NodePool<node_type> pool;
+        std::vector<node_type*> degreeTable;
+        key_compare compare;
     };
 }
 
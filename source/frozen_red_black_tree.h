@@ -0,0 +1,347 @@
+#ifndef FROZEN_RED_BLACK_TREE_H
+#define FROZEN_RED_BLACK_TREE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "red_black_tree.h"
+
+namespace algo
+{
+    class FrozenMapping
+    {
+    public:
+        FrozenMapping() noexcept = default;
+
+        explicit FrozenMapping(const std::filesystem::path& path)
+        {
+#if defined(_WIN32)
+            file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if(file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error{"Error: cannot open frozen tree file."};
+            }
+            LARGE_INTEGER fileSize{};
+            GetFileSizeEx(file, &fileSize);
+            bytes = static_cast<std::size_t>(fileSize.QuadPart);
+            mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(mapping == nullptr)
+            {
+                CloseHandle(file);
+                throw std::runtime_error{"Error: cannot map frozen tree file."};
+            }
+            address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if(address == nullptr)
+            {
+                CloseHandle(mapping);
+                CloseHandle(file);
+                throw std::runtime_error{"Error: cannot map frozen tree file."};
+            }
+#else
+            int descriptor{::open(path.c_str(), O_RDONLY)};
+            if(descriptor < 0)
+            {
+                throw std::runtime_error{"Error: cannot open frozen tree file."};
+            }
+            struct stat status{};
+            ::fstat(descriptor, &status);
+            bytes = static_cast<std::size_t>(status.st_size);
+            address = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, descriptor, 0);
+            ::close(descriptor);
+            if(address == MAP_FAILED)
+            {
+                address = nullptr;
+                throw std::runtime_error{"Error: cannot map frozen tree file."};
+            }
+#endif
+        }
+
+        FrozenMapping(const FrozenMapping&) = delete;
+        FrozenMapping& operator=(const FrozenMapping&) = delete;
+
+        FrozenMapping(FrozenMapping&& that) noexcept
+        {
+            swap(that);
+        }
+
+        FrozenMapping& operator=(FrozenMapping&& that) noexcept
+        {
+            FrozenMapping{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        ~FrozenMapping()
+        {
+            if(address == nullptr)
+            {
+                return;
+            }
+#if defined(_WIN32)
+            UnmapViewOfFile(address);
+            CloseHandle(mapping);
+            CloseHandle(file);
+#else
+            ::munmap(address, bytes);
+#endif
+        }
+
+        const std::byte* data() const noexcept
+        {
+            return static_cast<const std::byte*>(address);
+        }
+
+        std::size_t size() const noexcept
+        {
+            return bytes;
+        }
+
+        void swap(FrozenMapping& that) noexcept
+        {
+            std::swap(this->address, that.address);
+            std::swap(this->bytes, that.bytes);
+#if defined(_WIN32)
+            std::swap(this->file, that.file);
+            std::swap(this->mapping, that.mapping);
+#endif
+        }
+    private:
+        void* address{nullptr};
+        std::size_t bytes{0};
+#if defined(_WIN32)
+        HANDLE file{INVALID_HANDLE_VALUE};
+        HANDLE mapping{nullptr};
+#endif
+    };
+
+    // Keys and values are laid out in Eytzinger (breadth first) order inside one
+    // cache-line aligned block, which is also the on-disk format, so a saved tree can
+    // be mapped back and queried without any parsing or rebuilding. The file is only
+    // portable between machines with the same endianness and type layout.
+    template<typename Key,
+             typename Type,
+             typename Compare = std::less<Key>>
+    class FrozenRedBlackTree
+    {
+        static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Type>,
+                      "Frozen trees are stored as raw bytes.");
+    public:
+        using key_type = Key;
+        using value_type = Type;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using const_pointer = const value_type*;
+
+        static constexpr size_type cacheLine{64};
+
+        template<typename Node,
+                 typename Allocator>
+        explicit FrozenRedBlackTree(const RedBlackTree<Key, Type, Compare, Node, Allocator>& tree)
+            : owned{}, mapped{}
+            , header{nullptr}, keys{nullptr}
+            , values{nullptr}, compare{}
+        {
+            std::vector<std::pair<Key, Type>> sorted;
+            tree.for_each([&](const Key& key, const Type& data)
+            {
+                sorted.emplace_back(key, data);
+            });
+            size_type bytes{layout_bytes(sorted.size())};
+            owned.reset(static_cast<std::byte*>(::operator new(bytes, std::align_val_t{cacheLine})));
+            std::memset(owned.get(), 0, bytes);
+            Header* fresh{reinterpret_cast<Header*>(owned.get())};
+            *fresh = Header{magicNumber, sorted.size(), sizeof(Key), sizeof(Type),
+                            keys_offset(), values_offset(sorted.size()), bytes};
+            attach(owned.get());
+            Key* freshKeys{const_cast<Key*>(keys)};
+            Type* freshValues{const_cast<Type*>(values)};
+            size_type next{0};
+            fill(sorted, freshKeys, freshValues, 1, next);
+        }
+
+        FrozenRedBlackTree(FrozenRedBlackTree&&) noexcept = default;
+        FrozenRedBlackTree& operator=(FrozenRedBlackTree&&) noexcept = default;
+
+        static FrozenRedBlackTree map(const std::filesystem::path& path)
+        {
+            FrozenMapping mapping{path};
+            const Header* stored{reinterpret_cast<const Header*>(mapping.data())};
+            if(mapping.size() < sizeof(Header)
+               || stored->magic != magicNumber
+               || stored->keySize != sizeof(Key)
+               || stored->valueSize != sizeof(Type)
+               || stored->bytes != mapping.size()
+               || stored->count > mapping.size() / (sizeof(Key) + sizeof(Type))
+               || stored->bytes != layout_bytes(stored->count)
+               || stored->keysOffset != keys_offset()
+               || stored->valuesOffset != values_offset(stored->count))
+            {
+                throw std::runtime_error{"Error: wrong frozen tree file format."};
+            }
+            return FrozenRedBlackTree{std::move(mapping)};
+        }
+
+        void save(const std::filesystem::path& path) const
+        {
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(header->bytes));
+            if(!file)
+            {
+                throw std::runtime_error{"Error: cannot write frozen tree file."};
+            }
+        }
+
+        const_pointer find(const key_type& key) const
+        {
+            size_type position{lower_bound_position(key)};
+            if(position != 0
+               && !compare(key, keys[position]))
+            {
+                return values + position;
+            }
+            return nullptr;
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        size_type size() const noexcept
+        {
+            return header->count;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+    private:
+        struct Header
+        {
+            std::uint64_t magic;
+            std::uint64_t count;
+            std::uint32_t keySize;
+            std::uint32_t valueSize;
+            std::uint64_t keysOffset;
+            std::uint64_t valuesOffset;
+            std::uint64_t bytes;
+        };
+
+        struct AlignedDelete
+        {
+            void operator()(std::byte* memory) const noexcept
+            {
+                ::operator delete(memory, std::align_val_t{cacheLine});
+            }
+        };
+
+        static constexpr std::uint64_t magicNumber{0x5254424e5a4f5246};
+        static constexpr size_type prefetchStride{std::max<size_type>(1, cacheLine / sizeof(Key))};
+
+        explicit FrozenRedBlackTree(FrozenMapping&& mapping)
+            : owned{}, mapped{std::move(mapping)}
+            , header{nullptr}, keys{nullptr}
+            , values{nullptr}, compare{}
+        {
+            attach(mapped.data());
+        }
+
+        static constexpr size_type align_up(size_type bytes) noexcept
+        {
+            return (bytes + cacheLine - 1) / cacheLine * cacheLine;
+        }
+
+        static constexpr size_type keys_offset() noexcept
+        {
+            return align_up(sizeof(Header));
+        }
+
+        static constexpr size_type values_offset(size_type count) noexcept
+        {
+            return align_up(keys_offset() + (count + 1) * sizeof(Key));
+        }
+
+        static constexpr size_type layout_bytes(size_type count) noexcept
+        {
+            return align_up(values_offset(count) + (count + 1) * sizeof(Type));
+        }
+
+        void attach(const std::byte* base) noexcept
+        {
+            header = reinterpret_cast<const Header*>(base);
+            keys = reinterpret_cast<const Key*>(base + header->keysOffset);
+            values = reinterpret_cast<const Type*>(base + header->valuesOffset);
+        }
+
+        static void fill(const std::vector<std::pair<Key, Type>>& sorted, Key* freshKeys, Type* freshValues,
+                         size_type position, size_type& next)
+        {
+            if(position > sorted.size())
+            {
+                return;
+            }
+            fill(sorted, freshKeys, freshValues, 2 * position, next);
+            freshKeys[position] = sorted[next].first;
+            freshValues[position] = sorted[next].second;
+            ++next;
+            fill(sorted, freshKeys, freshValues, 2 * position + 1, next);
+        }
+
+        size_type lower_bound_position(const key_type& key) const
+        {
+            size_type count{header->count};
+            size_type position{1};
+            while(position <= count)
+            {
+                // The descendants log2(prefetchStride) levels down start at this index.
+                // Near the leaves it passes count, and forming that pointer would leave
+                // the array, so the last levels go without a prefetch.
+                const size_type ahead{position * prefetchStride};
+                if(ahead <= count)
+                {
+                    prefetch_address(keys + ahead);
+                }
+                position = 2 * position + static_cast<size_type>(compare(keys[position], key));
+            }
+            return position >> (std::countr_one(position) + 1);
+        }
+
+        std::unique_ptr<std::byte, AlignedDelete> owned;
+        FrozenMapping mapped;
+        const Header* header;
+        const Key* keys;
+        const Type* values;
+        key_compare compare;
+    };
+
+    template<typename Key,
+             typename Type,
+             typename Compare,
+             typename Node,
+             typename Allocator>
+    FrozenRedBlackTree<Key, Type, Compare> freeze(const RedBlackTree<Key, Type, Compare, Node, Allocator>& tree)
+    {
+        return FrozenRedBlackTree<Key, Type, Compare>{tree};
+    }
+}
+
+#endif
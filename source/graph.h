@@ -0,0 +1,324 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "addressable_heap.h"
+#include "dary_heap.h"
+
+namespace algo
+{
+    template<typename Weight>
+    struct WeightedEdge
+    {
+        std::uint32_t source;
+        std::uint32_t target;
+        Weight weight;
+    };
+
+    template<typename Weight>
+    struct GraphArc
+    {
+        std::uint32_t target;
+        Weight weight;
+    };
+
+    enum class GraphKind
+    {
+        directed,
+        undirected
+    };
+
+    // Compressed sparse row adjacency: the arcs leaving vertex v are stored contiguously
+    // in arcs[offsets[v], offsets[v + 1]), in the order their edges were given.
+    template<typename Weight>
+    class CompressedGraph
+    {
+    public:
+        using vertex_type = std::uint32_t;
+        using weight_type = Weight;
+        using size_type = std::size_t;
+        using edge_type = WeightedEdge<Weight>;
+        using arc_type = GraphArc<Weight>;
+
+        CompressedGraph()
+            : offsets(1, 0), arcs{}
+        {
+        }
+
+        CompressedGraph(size_type vertexCount, std::span<const edge_type> edges, GraphKind kind = GraphKind::directed)
+            : offsets(vertexCount + 1, 0), arcs{}
+        {
+            if(vertexCount >= std::numeric_limits<vertex_type>::max())
+            {
+                throw std::length_error{"Error: too many vertices."};
+            }
+            for(const auto& edge : edges)
+            {
+                if(edge.source >= vertexCount
+                   || edge.target >= vertexCount)
+                {
+                    throw std::out_of_range{"Error: edge endpoint is not a vertex."};
+                }
+                ++offsets[edge.source + 1];
+                if(kind == GraphKind::undirected)
+                {
+                    ++offsets[edge.target + 1];
+                }
+            }
+            for(size_type vertex{0}; vertex < vertexCount; ++vertex)
+            {
+                offsets[vertex + 1] += offsets[vertex];
+            }
+            arcs.resize(offsets.back());
+            std::vector<size_type> next(offsets.begin(), offsets.end() - 1);
+            for(const auto& edge : edges)
+            {
+                arcs[next[edge.source]++] = arc_type{edge.target, edge.weight};
+                if(kind == GraphKind::undirected)
+                {
+                    arcs[next[edge.target]++] = arc_type{edge.source, edge.weight};
+                }
+            }
+        }
+
+        size_type vertex_count() const noexcept
+        {
+            return offsets.size() - 1;
+        }
+
+        size_type arc_count() const noexcept
+        {
+            return arcs.size();
+        }
+
+        size_type degree(vertex_type vertex) const noexcept
+        {
+            return offsets[vertex + 1] - offsets[vertex];
+        }
+
+        std::span<const arc_type> arcs_of(vertex_type vertex) const noexcept
+        {
+            return {arcs.data() + offsets[vertex], degree(vertex)};
+        }
+    private:
+        std::vector<size_type> offsets;
+        std::vector<arc_type> arcs;
+    };
+
+    // The heaps take a comparator, and dary_heap an arity, after the key. Binding them
+    // to a one-parameter template template parameter relies on P0522, which Clang only
+    // enables by default from version 19, so the one-parameter shape comes from an alias.
+    template<typename Entry>
+    using QuaternaryHeap = dary_heap<Entry>;
+
+    // Runs single-source searches over one graph with any AddressableHeap of
+    // (priority, vertex) pairs. Per-vertex state is kept between queries and
+    // invalidated by bumping a generation counter, so a query only touches the
+    // vertices it reaches and, once the heap has grown, does not allocate.
+    template<typename Weight,
+             template<typename> class Heap = QuaternaryHeap>
+    class GraphSearch
+    {
+    public:
+        using graph_type = CompressedGraph<Weight>;
+        using vertex_type = typename graph_type::vertex_type;
+        using weight_type = Weight;
+        using size_type = std::size_t;
+        using entry_type = std::pair<Weight, vertex_type>;
+        using heap_type = Heap<entry_type>;
+
+        static_assert(AddressableHeap<heap_type>, "GraphSearch needs an addressable heap.");
+
+        static constexpr vertex_type noVertex{std::numeric_limits<vertex_type>::max()};
+        static constexpr weight_type unreachable{std::numeric_limits<weight_type>::max()};
+
+        explicit GraphSearch(const graph_type& graph)
+            : graph{&graph}, heap{}
+            , distances(graph.vertex_count()), parents(graph.vertex_count())
+            , handles(graph.vertex_count()), labelled(graph.vertex_count(), 0)
+            , settled(graph.vertex_count(), 0), generation{0}
+            , settledCount{0}
+        {
+        }
+
+        // Settles vertices in order of distance from source, stopping early once
+        // target is settled when one is given.
+        void dijkstra(vertex_type source, vertex_type target = noVertex)
+        {
+            a_star(source, target, [](vertex_type){ return weight_type{}; });
+        }
+
+        // The heuristic must be consistent: it never overestimates and never drops by
+        // more than an arc's weight along that arc, so settled vertices are final.
+        template<typename Heuristic>
+            requires std::convertible_to<std::invoke_result_t<Heuristic&, vertex_type>, weight_type>
+        void a_star(vertex_type source, vertex_type target, Heuristic heuristic)
+        {
+            begin_query(source);
+            label(source, weight_type{}, noVertex, heuristic(source));
+            while(!heap.empty())
+            {
+                vertex_type vertex{heap.top().second};
+                heap.pop();
+                settle(vertex);
+                if(vertex == target)
+                {
+                    return;
+                }
+                for(const auto& arc : graph->arcs_of(vertex))
+                {
+                    if(is_settled(arc.target))
+                    {
+                        continue;
+                    }
+                    weight_type candidate{distances[vertex] + arc.weight};
+                    if(!is_labelled(arc.target))
+                    {
+                        label(arc.target, candidate, vertex, candidate + heuristic(arc.target));
+                    }
+                    else if(candidate < distances[arc.target])
+                    {
+                        improve(arc.target, candidate, vertex, candidate + heuristic(arc.target));
+                    }
+                }
+            }
+        }
+
+        // Grows a minimum spanning tree over the component of root and returns its
+        // weight; parent() gives the tree edges and distance() each vertex's edge weight.
+        // The priorities here are edge weights, which are not monotone, so a radix_heap
+        // cannot be used.
+        weight_type prim(vertex_type root)
+        {
+            begin_query(root);
+            label(root, weight_type{}, noVertex, weight_type{});
+            weight_type total{};
+            while(!heap.empty())
+            {
+                vertex_type vertex{heap.top().second};
+                heap.pop();
+                settle(vertex);
+                total += distances[vertex];
+                for(const auto& arc : graph->arcs_of(vertex))
+                {
+                    if(is_settled(arc.target))
+                    {
+                        continue;
+                    }
+                    if(!is_labelled(arc.target))
+                    {
+                        label(arc.target, arc.weight, vertex, arc.weight);
+                    }
+                    else if(arc.weight < distances[arc.target])
+                    {
+                        improve(arc.target, arc.weight, vertex, arc.weight);
+                    }
+                }
+            }
+            return total;
+        }
+
+        bool reached(vertex_type vertex) const noexcept
+        {
+            return is_settled(vertex);
+        }
+
+        weight_type distance(vertex_type vertex) const noexcept
+        {
+            return is_settled(vertex)? distances[vertex] : unreachable;
+        }
+
+        vertex_type parent(vertex_type vertex) const noexcept
+        {
+            return is_settled(vertex)? parents[vertex] : noVertex;
+        }
+
+        size_type settled_count() const noexcept
+        {
+            return settledCount;
+        }
+
+        // Vertices from the source of the last query to target, or empty if target was not reached.
+        std::vector<vertex_type> path(vertex_type target) const
+        {
+            std::vector<vertex_type> result;
+            if(!is_settled(target))
+            {
+                return result;
+            }
+            for(vertex_type vertex{target}; vertex != noVertex; vertex = parents[vertex])
+            {
+                result.push_back(vertex);
+            }
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+    private:
+        void begin_query(vertex_type source)
+        {
+            if(source >= graph->vertex_count())
+            {
+                throw std::out_of_range{"Error: source is not a vertex."};
+            }
+            heap.clear();
+            if(++generation == 0)
+            {
+                std::fill(labelled.begin(), labelled.end(), 0);
+                std::fill(settled.begin(), settled.end(), 0);
+                generation = 1;
+            }
+            settledCount = 0;
+        }
+
+        bool is_labelled(vertex_type vertex) const noexcept
+        {
+            return labelled[vertex] == generation;
+        }
+
+        bool is_settled(vertex_type vertex) const noexcept
+        {
+            return settled[vertex] == generation;
+        }
+
+        void label(vertex_type vertex, weight_type distance, vertex_type parent, weight_type priority)
+        {
+            labelled[vertex] = generation;
+            distances[vertex] = distance;
+            parents[vertex] = parent;
+            handles[vertex] = heap.push(entry_type{priority, vertex});
+        }
+
+        void improve(vertex_type vertex, weight_type distance, vertex_type parent, weight_type priority)
+        {
+            distances[vertex] = distance;
+            parents[vertex] = parent;
+            heap.decrease_key(handles[vertex], entry_type{priority, vertex});
+        }
+
+        void settle(vertex_type vertex) noexcept
+        {
+            settled[vertex] = generation;
+            ++settledCount;
+        }
+
+        const graph_type* graph;
+        heap_type heap;
+        std::vector<weight_type> distances;
+        std::vector<vertex_type> parents;
+        std::vector<typename heap_type::handle> handles;
+        std::vector<std::uint32_t> labelled;
+        std::vector<std::uint32_t> settled;
+        std::uint32_t generation;
+        size_type settledCount;
+    };
+}
+
+#endif
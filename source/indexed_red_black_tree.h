@@ -0,0 +1,481 @@
+#ifndef INDEXED_RED_BLACK_TREE_H
+#define INDEXED_RED_BLACK_TREE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "red_black_tree.h"
+
+namespace algo
+{
+    // Links are 31 bit slot indices into the owning tree's node array and the color
+    // takes the remaining high bit of the left link, so an int -> int entry is 16 bytes.
+    template<typename Key,
+             typename Type>
+    struct IndexedRedBlackNode
+    {
+        using index_type = std::uint32_t;
+
+        static constexpr index_type colorMask{index_type{1} << 31};
+        static constexpr index_type nil{colorMask - 1};
+
+        template<typename... Args>
+        IndexedRedBlackNode(index_type left,
+                            index_type right,
+                            RedBlackColor color,
+                            Key key, Args&&... args)
+            : leftAndColor{left | (color == RedBlackColor::black? colorMask : 0)}, right{right}
+            , key{std::move(key)}, data{std::forward<Args>(args)...}
+        {
+        }
+
+        index_type get_left() const noexcept
+        {
+            return leftAndColor & ~colorMask;
+        }
+
+        void set_left(index_type fresh) noexcept
+        {
+            leftAndColor = fresh | (leftAndColor & colorMask);
+        }
+
+        RedBlackColor get_color() const noexcept
+        {
+            return (leftAndColor & colorMask)? RedBlackColor::black : RedBlackColor::red;
+        }
+
+        void set_color(RedBlackColor fresh) noexcept
+        {
+            leftAndColor = get_left() | (fresh == RedBlackColor::black? colorMask : 0);
+        }
+
+        index_type leftAndColor;
+        index_type right;
+        const Key key;
+        Type data;
+    };
+
+    // Nodes are kept dense in one array: remove moves the last slot into the freed one,
+    // so iterators are invalidated by any insertion or removal.
+    template<typename Key,
+             typename Type,
+             typename Compare = std::less<Key>>
+    class IndexedRedBlackTree
+    {
+    public:
+        using key_type = Key;
+        using value_type = Type;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using difference_type = std::ptrdiff_t;
+        using node_type = IndexedRedBlackNode<Key, Type>;
+        using index_type = typename node_type::index_type;
+        using allocator_type = std::allocator<node_type>;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = node_type*;
+
+        static constexpr index_type nil{node_type::nil};
+
+        IndexedRedBlackTree()
+            : root{nil}, nodes{}
+            , compare{}
+        {
+        }
+
+        template<typename... Args>
+        iterator emplace(const key_type& key, Args&&... args)
+        {
+            if(index_type found{lookup(key)}; found != nil)
+            {
+                return iterator{&nodes[found]};
+            }
+            if(nodes.size() == nil)
+            {
+                throw std::length_error{"Error: indexed tree is full."};
+            }
+            nodes.emplace_back(nil, nil, RedBlackColor::red, key, std::forward<Args>(args)...);
+            index_type fresh{static_cast<index_type>(nodes.size() - 1)};
+            root = insert_subtree(root, fresh);
+            nodes[root].set_color(RedBlackColor::black);
+            return iterator{&nodes[fresh]};
+        }
+
+        iterator insert(const key_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        void remove(const key_type& key)
+        {
+            index_type found{lookup(key)};
+            if(found == nil)
+            {
+                return;
+            }
+            bool shortened{false};
+            root = remove_subtree(root, key, &shortened);
+            if(root != nil)
+            {
+                nodes[root].set_color(RedBlackColor::black);
+            }
+            release_slot(found);
+        }
+
+        reference operator[](const key_type& key)
+        {
+            return emplace(key, value_type{})->data;
+        }
+
+        iterator find(const key_type& key)
+        {
+            index_type found{lookup(key)};
+            return found == nil? nullptr : iterator{&nodes[found]};
+        }
+
+        template<typename Function>
+        void for_each(Function function) const
+        {
+            for_each_subtree(root, function);
+        }
+
+        size_type size() const noexcept
+        {
+            return nodes.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return root == nil;
+        }
+
+        void reserve(size_type capacity)
+        {
+            nodes.reserve(capacity);
+        }
+
+        void clear()
+        {
+            nodes.clear();
+            root = nil;
+        }
+    private:
+        index_type left_of(index_type node) const noexcept
+        {
+            return nodes[node].get_left();
+        }
+
+        index_type right_of(index_type node) const noexcept
+        {
+            return nodes[node].right;
+        }
+
+        void set_left(index_type node, index_type child) noexcept
+        {
+            nodes[node].set_left(child);
+        }
+
+        void set_right(index_type node, index_type child) noexcept
+        {
+            nodes[node].right = child;
+        }
+
+        void set_color(index_type node, RedBlackColor color) noexcept
+        {
+            nodes[node].set_color(color);
+        }
+
+        bool is_node_red(index_type node) const noexcept
+        {
+            return node != nil && nodes[node].get_color() == RedBlackColor::red;
+        }
+
+        index_type lookup(const key_type& key) const
+        {
+            index_type position{root};
+            while(position != nil)
+            {
+                if(compare(key, nodes[position].key))
+                {
+                    position = left_of(position);
+                }
+                else if(compare(nodes[position].key, key))
+                {
+                    position = right_of(position);
+                }
+                else
+                {
+                    break;
+                }
+            }
+            return position;
+        }
+
+        void release_slot(index_type slot)
+        {
+            index_type last{static_cast<index_type>(nodes.size() - 1)};
+            if(slot != last)
+            {
+                relink(last, slot);
+                std::destroy_at(&nodes[slot]);
+                std::construct_at(&nodes[slot], std::move(nodes[last]));
+            }
+            nodes.pop_back();
+        }
+
+        void relink(index_type from, index_type to)
+        {
+            if(root == from)
+            {
+                root = to;
+                return;
+            }
+            index_type position{root};
+            while(true)
+            {
+                if(compare(nodes[from].key, nodes[position].key))
+                {
+                    if(left_of(position) == from)
+                    {
+                        set_left(position, to);
+                        return;
+                    }
+                    position = left_of(position);
+                }
+                else
+                {
+                    if(right_of(position) == from)
+                    {
+                        set_right(position, to);
+                        return;
+                    }
+                    position = right_of(position);
+                }
+            }
+        }
+
+        index_type insert_subtree(index_type node, index_type fresh)
+        {
+            if(node == nil)
+            {
+                return fresh;
+            }
+            if(compare(nodes[fresh].key, nodes[node].key))
+            {
+                set_left(node, insert_subtree(left_of(node), fresh));
+            }
+            else
+            {
+                set_right(node, insert_subtree(right_of(node), fresh));
+            }
+            return insert_balance(node);
+        }
+
+        index_type insert_balance(index_type node) noexcept
+        {
+            if(is_node_red(node))
+            {
+                return node;
+            }
+            index_type top{nil};
+            index_type lower{nil};
+            index_type upper{nil};
+            index_type left{left_of(node)};
+            index_type right{right_of(node)};
+            if(is_node_red(left) && is_node_red(left_of(left)))
+            {
+                top = left;
+                lower = left_of(top);
+                upper = node;
+                set_left(upper, right_of(top));
+            }
+            else if(is_node_red(left) && is_node_red(right_of(left)))
+            {
+                lower = left;
+                top = right_of(lower);
+                upper = node;
+                set_right(lower, left_of(top));
+                set_left(upper, right_of(top));
+            }
+            else if(is_node_red(right) && is_node_red(left_of(right)))
+            {
+                lower = node;
+                upper = right;
+                top = left_of(upper);
+                set_right(lower, left_of(top));
+                set_left(upper, right_of(top));
+            }
+            else if(is_node_red(right) && is_node_red(right_of(right)))
+            {
+                top = right;
+                lower = node;
+                upper = right_of(top);
+                set_right(lower, left_of(top));
+            }
+            else
+            {
+                return node;
+            }
+            set_left(top, lower);
+            set_right(top, upper);
+            set_color(top, RedBlackColor::red);
+            set_color(lower, RedBlackColor::black);
+            set_color(upper, RedBlackColor::black);
+            return top;
+        }
+
+        index_type remove_subtree(index_type node, const key_type& key, bool* shortened)
+        {
+            if(compare(key, nodes[node].key))
+            {
+                set_left(node, remove_subtree(left_of(node), key, shortened));
+                return *shortened? fix_left_shortened(node, shortened) : node;
+            }
+            if(compare(nodes[node].key, key))
+            {
+                set_right(node, remove_subtree(right_of(node), key, shortened));
+                return *shortened? fix_right_shortened(node, shortened) : node;
+            }
+            if(left_of(node) == nil
+               || right_of(node) == nil)
+            {
+                return unlink_single(node, shortened);
+            }
+            index_type successor{nil};
+            index_type right{remove_minimum(right_of(node), &successor, shortened)};
+            set_left(successor, left_of(node));
+            set_right(successor, right);
+            set_color(successor, nodes[node].get_color());
+            return *shortened? fix_right_shortened(successor, shortened) : successor;
+        }
+
+        index_type remove_minimum(index_type node, index_type* minimum, bool* shortened)
+        {
+            if(left_of(node) == nil)
+            {
+                *minimum = node;
+                return unlink_single(node, shortened);
+            }
+            set_left(node, remove_minimum(left_of(node), minimum, shortened));
+            return *shortened? fix_left_shortened(node, shortened) : node;
+        }
+
+        index_type unlink_single(index_type node, bool* shortened) noexcept
+        {
+            index_type child{left_of(node) != nil? left_of(node) : right_of(node)};
+            *shortened = false;
+            if(!is_node_red(node))
+            {
+                if(is_node_red(child))
+                {
+                    set_color(child, RedBlackColor::black);
+                }
+                else
+                {
+                    *shortened = true;
+                }
+            }
+            set_left(node, nil);
+            set_right(node, nil);
+            return child;
+        }
+
+        index_type fix_left_shortened(index_type node, bool* shortened) noexcept
+        {
+            index_type sibling{right_of(node)};
+            if(is_node_red(sibling))
+            {
+                set_right(node, left_of(sibling));
+                set_color(sibling, RedBlackColor::black);
+                set_color(node, RedBlackColor::red);
+                set_left(sibling, fix_left_shortened(node, shortened));
+                *shortened = false;
+                return sibling;
+            }
+            if(!is_node_red(left_of(sibling))
+               && !is_node_red(right_of(sibling)))
+            {
+                set_color(sibling, RedBlackColor::red);
+                *shortened = !is_node_red(node);
+                set_color(node, RedBlackColor::black);
+                return node;
+            }
+            if(!is_node_red(right_of(sibling)))
+            {
+                index_type inner{left_of(sibling)};
+                set_left(sibling, right_of(inner));
+                set_right(inner, sibling);
+                set_color(inner, RedBlackColor::black);
+                set_color(sibling, RedBlackColor::red);
+                sibling = inner;
+            }
+            set_color(right_of(sibling), RedBlackColor::black);
+            set_color(sibling, nodes[node].get_color());
+            set_color(node, RedBlackColor::black);
+            set_right(node, left_of(sibling));
+            set_left(sibling, node);
+            *shortened = false;
+            return sibling;
+        }
+
+        index_type fix_right_shortened(index_type node, bool* shortened) noexcept
+        {
+            index_type sibling{left_of(node)};
+            if(is_node_red(sibling))
+            {
+                set_left(node, right_of(sibling));
+                set_color(sibling, RedBlackColor::black);
+                set_color(node, RedBlackColor::red);
+                set_right(sibling, fix_right_shortened(node, shortened));
+                *shortened = false;
+                return sibling;
+            }
+            if(!is_node_red(left_of(sibling))
+               && !is_node_red(right_of(sibling)))
+            {
+                set_color(sibling, RedBlackColor::red);
+                *shortened = !is_node_red(node);
+                set_color(node, RedBlackColor::black);
+                return node;
+            }
+            if(!is_node_red(left_of(sibling)))
+            {
+                index_type inner{right_of(sibling)};
+                set_right(sibling, left_of(inner));
+                set_left(inner, sibling);
+                set_color(inner, RedBlackColor::black);
+                set_color(sibling, RedBlackColor::red);
+                sibling = inner;
+            }
+            set_color(left_of(sibling), RedBlackColor::black);
+            set_color(sibling, nodes[node].get_color());
+            set_color(node, RedBlackColor::black);
+            set_left(node, right_of(sibling));
+            set_right(sibling, node);
+            *shortened = false;
+            return sibling;
+        }
+
+        template<typename Function>
+        void for_each_subtree(index_type node, Function& function) const
+        {
+            while(node != nil)
+            {
+                for_each_subtree(left_of(node), function);
+                function(nodes[node].key, nodes[node].data);
+                node = right_of(node);
+            }
+        }
+
+        index_type root;
+        std::vector<node_type, allocator_type> nodes;
+        key_compare compare;
+    };
+}
+
+#endif
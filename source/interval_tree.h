@@ -0,0 +1,337 @@
+#ifndef INTERVAL_TREE_H
+#define INTERVAL_TREE_H
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "red_black_tree.h"
+
+namespace algo
+{
+    template<typename Point>
+    struct Interval
+    {
+        Point low;
+        Point high;
+
+        auto operator<=>(const Interval&) const = default;
+    };
+
+    // Tree key of IntervalTree: equal intervals are ordered by when they were inserted.
+    template<typename Point>
+    struct SequencedInterval : Interval<Point>
+    {
+        std::uint64_t sequence;
+
+        auto operator<=>(const SequencedInterval&) const = default;
+    };
+
+    template<typename Point,
+             typename Type>
+    struct IntervalRedBlackNode
+    {
+        template<typename... Args>
+        IntervalRedBlackNode(IntervalRedBlackNode* parent,
+                             IntervalRedBlackNode* left,
+                             IntervalRedBlackNode* right,
+                             RedBlackColor color,
+                             SequencedInterval<Point> key, Args&&... args)
+            : parent{parent}, left{left}
+            , right{right}, color{color}
+            , key{std::move(key)}, data{std::forward<Args>(args)...}
+            , maxHigh{this->key.high}
+        {
+        }
+
+        IntervalRedBlackNode* get_parent() const noexcept
+        {
+            return parent;
+        }
+
+        void set_parent(IntervalRedBlackNode* fresh) noexcept
+        {
+            parent = fresh;
+        }
+
+        RedBlackColor get_color() const noexcept
+        {
+            return color;
+        }
+
+        void set_color(RedBlackColor fresh) noexcept
+        {
+            color = fresh;
+        }
+
+        void update_augment() noexcept
+        {
+            maxHigh = key.high;
+            if(left && maxHigh < left->maxHigh)
+            {
+                maxHigh = left->maxHigh;
+            }
+            if(right && maxHigh < right->maxHigh)
+            {
+                maxHigh = right->maxHigh;
+            }
+        }
+
+        IntervalRedBlackNode* parent;
+        IntervalRedBlackNode* left;
+        IntervalRedBlackNode* right;
+        RedBlackColor color;
+        const SequencedInterval<Point> key;
+        Type data;
+        Point maxHigh;
+    };
+
+    // Closed intervals ordered by (low, high), equal intervals kept in insertion order.
+    // Every node keeps the largest high endpoint of its subtree, which the base tree
+    // refreshes after each structural change. The base tree is private so that every
+    // insertion goes through the low <= high check.
+    //
+    // Queries walk the tree lazily in low order through parent links, so results can
+    // be consumed one at a time while the tree is not modified. The walk skips subtrees
+    // whose largest endpoint is below the query, but it still passes through the nodes
+    // on the way to each reported interval: k results cost O(min(n, (k + 1) log n)),
+    // not the O(log n + k) of a priority search tree.
+    template<typename Point,
+             typename Type>
+    class IntervalTree : private RedBlackTree<SequencedInterval<Point>, Type, std::less<SequencedInterval<Point>>, IntervalRedBlackNode<Point, Type>>
+    {
+        using base_type = RedBlackTree<SequencedInterval<Point>, Type, std::less<SequencedInterval<Point>>, IntervalRedBlackNode<Point, Type>>;
+    public:
+        using point_type = Point;
+        using interval_type = Interval<Point>;
+        using typename base_type::node_type;
+        using typename base_type::iterator;
+        using typename base_type::value_type;
+        using typename base_type::size_type;
+        using typename base_type::allocator_type;
+
+        class OverlapIterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = node_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const node_type*;
+            using reference = const node_type&;
+
+            OverlapIterator() noexcept
+                : node{nullptr}, query{}
+            {
+            }
+
+            OverlapIterator(node_type* node, interval_type query) noexcept
+                : node{node}, query{query}
+            {
+                this->node = settle(node);
+            }
+
+            reference operator*() const noexcept
+            {
+                return *node;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return node;
+            }
+
+            OverlapIterator& operator++() noexcept
+            {
+                node = settle(successor(node));
+                return *this;
+            }
+
+            OverlapIterator operator++(int) noexcept
+            {
+                OverlapIterator previous{*this};
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const OverlapIterator& that) const noexcept
+            {
+                return node == that.node;
+            }
+        private:
+            bool is_reachable(const node_type* subtree) const noexcept
+            {
+                return subtree && !(subtree->maxHigh < query.low);
+            }
+
+            node_type* leftmost(node_type* subtree) const noexcept
+            {
+                while(is_reachable(subtree->left))
+                {
+                    subtree = subtree->left;
+                }
+                return subtree;
+            }
+
+            node_type* successor(node_type* position) const noexcept
+            {
+                if(!(query.high < position->key.low)
+                   && is_reachable(position->right))
+                {
+                    return leftmost(position->right);
+                }
+                while(position->get_parent()
+                      && position->get_parent()->right == position)
+                {
+                    position = position->get_parent();
+                }
+                return position->get_parent();
+            }
+
+            node_type* settle(node_type* position) const noexcept
+            {
+                while(position)
+                {
+                    if(query.high < position->key.low)
+                    {
+                        return nullptr;
+                    }
+                    if(!(position->key.high < query.low))
+                    {
+                        return position;
+                    }
+                    position = successor(position);
+                }
+                return nullptr;
+            }
+
+            node_type* node;
+            interval_type query;
+        };
+
+        class OverlapRange
+        {
+        public:
+            OverlapRange(OverlapIterator first) noexcept
+                : first{first}
+            {
+            }
+
+            OverlapIterator begin() const noexcept
+            {
+                return first;
+            }
+
+            OverlapIterator end() const noexcept
+            {
+                return OverlapIterator{};
+            }
+        private:
+            OverlapIterator first;
+        };
+
+        using base_type::base_type;
+        using base_type::empty;
+        using base_type::clear;
+        using base_type::get_allocator;
+        using base_type::shape;
+        using base_type::validate;
+
+        template<typename... Args>
+        iterator emplace(const interval_type& key, Args&&... args)
+        {
+            if(key.high < key.low)
+            {
+                throw std::invalid_argument{"Error: interval low endpoint is above its high endpoint."};
+            }
+            return base_type::emplace(SequencedInterval<Point>{key, nextSequence++}, std::forward<Args>(args)...);
+        }
+
+        iterator insert(const interval_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        // Finds or removes the earliest inserted copy of key.
+        iterator find(const interval_type& key) const
+        {
+            node_type* found{this->lower_bound_node(SequencedInterval<Point>{key, 0})};
+            return found && static_cast<const interval_type&>(found->key) == key? found : nullptr;
+        }
+
+        bool contains(const interval_type& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        void remove(const interval_type& key)
+        {
+            this->remove_node(find(key));
+        }
+
+        template<typename Function>
+        void for_each(Function function) const
+        {
+            base_type::for_each([&](const SequencedInterval<Point>& key, const value_type& value)
+            {
+                function(static_cast<const interval_type&>(key), value);
+            });
+        }
+
+        // Moves every interval ordered at or after key into the returned tree.
+        IntervalTree split(const interval_type& key)
+        {
+            return IntervalTree{base_type::split(SequencedInterval<Point>{key, 0}), nextSequence};
+        }
+
+        // Every interval of upper must order after every interval of this tree.
+        void join2(IntervalTree&& upper)
+        {
+            nextSequence = std::max(nextSequence, upper.nextSequence);
+            base_type::join2(std::move(upper));
+        }
+
+        void swap(IntervalTree& that) noexcept
+        {
+            base_type::swap(that);
+            std::swap(nextSequence, that.nextSequence);
+        }
+
+        OverlapRange overlapping(const point_type& low, const point_type& high) const
+        {
+            if(high < low)
+            {
+                throw std::invalid_argument{"Error: query low endpoint is above its high endpoint."};
+            }
+            interval_type query{low, high};
+            node_type* root{this->root};
+            if(root == nullptr
+               || root->maxHigh < low)
+            {
+                return OverlapRange{OverlapIterator{}};
+            }
+            while(root->left
+                  && !(root->left->maxHigh < low))
+            {
+                root = root->left;
+            }
+            return OverlapRange{OverlapIterator{root, query}};
+        }
+
+        OverlapRange stabbing(const point_type& point) const
+        {
+            return overlapping(point, point);
+        }
+    private:
+        IntervalTree(base_type&& tree, std::uint64_t nextSequence)
+            : base_type{std::move(tree)}, nextSequence{nextSequence}
+        {
+        }
+
+        std::uint64_t nextSequence{0};
+    };
+}
+
+#endif
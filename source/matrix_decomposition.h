@@ -0,0 +1,589 @@
+#ifndef MATRIX_DECOMPOSITION_H
+#define MATRIX_DECOMPOSITION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "dynamic_matrix.h"
+#include "matrix_multiply.h"
+
+namespace algo
+{
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    struct QrFactorization
+    {
+        DynamicMatrix<Type, Allocator> q;
+        DynamicMatrix<Type, Allocator> r;
+    };
+
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    struct SvdResult
+    {
+        DynamicMatrix<Type, Allocator> u;
+        std::vector<Type> singularValues;
+        DynamicMatrix<Type, Allocator> v;
+    };
+
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    struct EigenResult
+    {
+        std::vector<Type> eigenvalues;
+        DynamicMatrix<Type, Allocator> vectors;
+    };
+
+    // Entries are standard normal, drawn with Box-Muller from mt19937_64, whose output
+    // the standard fixes. std::normal_distribution is implementation defined, so using
+    // it would give different matrices for the same seed on different libraries.
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    DynamicMatrix<Type, Allocator> gaussian_matrix(const std::size_t rows, const std::size_t cols, const std::uint64_t seed,
+                                                   const Allocator& memory = Allocator{})
+    {
+        std::mt19937_64 engine{seed};
+        const auto uniform{[&engine]
+        {
+            return (static_cast<double>(engine() >> 11) + 0.5) * 0x1.0p-53;
+        }};
+        DynamicMatrix<Type, Allocator> matrix{rows, cols, memory};
+        for(std::size_t index{0}; index < matrix.size(); index += 2)
+        {
+            const double radius{std::sqrt(-2 * std::log(uniform()))};
+            const double angle{2 * std::numbers::pi * uniform()};
+            matrix.data()[index] = static_cast<Type>(radius * std::cos(angle));
+            if(index + 1 < matrix.size())
+            {
+                matrix.data()[index + 1] = static_cast<Type>(radius * std::sin(angle));
+            }
+        }
+        return matrix;
+    }
+
+    // Applies the block reflector I - V T V^T, or its transpose, to target from the left.
+    // Every step is a matrix product, so a panel of reflectors costs three GEMMs.
+    template<typename Type, typename Allocator>
+    void apply_block_reflector(const MatrixView<const Type> reflectors, const DynamicMatrix<Type, Allocator>& factor,
+                               const MatrixView<Type> target, const bool transpose)
+    {
+        DynamicMatrix<Type, Allocator> projected{reflectors.cols, target.cols, factor.get_allocator()};
+        DynamicMatrix<Type, Allocator> scaled{reflectors.cols, target.cols, factor.get_allocator()};
+        multiply_transposed_into(reflectors, target, matrix_view(projected));
+        if(transpose)
+        {
+            multiply_transposed_into(matrix_view(factor), matrix_view(std::as_const(projected)), matrix_view(scaled));
+        }
+        else
+        {
+            multiply_into(matrix_view(factor), matrix_view(std::as_const(projected)), matrix_view(scaled));
+        }
+        for(auto& element : scaled)
+        {
+            element = -element;
+        }
+        multiply_into(reflectors, matrix_view(std::as_const(scaled)), target, true);
+    }
+
+    // Blocked Householder QR of a matrix with at least as many rows as columns; returns
+    // the thin factors. Each panel of blockSize columns is factored one column at a
+    // time, then its reflectors are merged into I - V T V^T (the compact WY form), so
+    // the trailing columns, and later Q, are updated by apply_block_reflector.
+    template<typename Type, typename Allocator>
+    QrFactorization<Type, Allocator> thin_qr(DynamicMatrix<Type, Allocator> matrix, const std::size_t blockSize = 32)
+    {
+        static_assert(std::is_floating_point_v<Type>, "QR needs a floating point type.");
+        const std::size_t rows{matrix.rows()};
+        const std::size_t cols{matrix.cols()};
+        if(rows < cols)
+        {
+            throw std::invalid_argument{"Error: thin QR needs at least as many rows as columns."};
+        }
+        const std::size_t panelWidth{std::max<std::size_t>(1, blockSize)};
+        const Allocator memory{matrix.get_allocator()};
+        const MatrixView<Type> a{matrix_view(matrix)};
+        std::vector<Type> tau(cols);
+        std::vector<DynamicMatrix<Type, Allocator>> factors;
+
+        // The reflectors of a panel stored below the diagonal, with the implicit unit
+        // diagonal and zeros above it written out.
+        const auto panel_reflectors{[&](const std::size_t start, const std::size_t width)
+        {
+            DynamicMatrix<Type, Allocator> reflectors{rows - start, width, memory};
+            for(std::size_t row{0}; row < rows - start; ++row)
+            {
+                for(std::size_t col{0}; col < width; ++col)
+                {
+                    reflectors[row, col] = row == col? Type{1} : row > col? a[start + row, start + col] : Type{0};
+                }
+            }
+            return reflectors;
+        }};
+
+        for(std::size_t start{0}; start < cols; start += panelWidth)
+        {
+            const std::size_t width{std::min(panelWidth, cols - start)};
+            // Two sweeps down the panel per column: one gathers the column norm together
+            // with its dot products against the columns to its right, the other scales the
+            // reflector and updates those columns. Both walk the panel row by row.
+            std::vector<Type> sums(width);
+            std::vector<Type> updates(width);
+            for(std::size_t col{start}; col < start + width; ++col)
+            {
+                const std::size_t end{start + width};
+                std::fill(sums.begin(), sums.end(), Type{0});
+                for(std::size_t row{col + 1}; row < rows; ++row)
+                {
+                    const Type lead{a[row, col]};
+                    for(std::size_t next{col}; next < end; ++next)
+                    {
+                        sums[next - col] += lead * a[row, next];
+                    }
+                }
+                const Type norm{std::sqrt(sums[0])};
+                const Type alpha{a[col, col]};
+                if(norm == Type{0})
+                {
+                    tau[col] = Type{0};
+                    continue;
+                }
+                const Type beta{-std::copysign(std::hypot(alpha, norm), alpha)};
+                tau[col] = (beta - alpha) / beta;
+                const Type scale{Type{1} / (alpha - beta)};
+                a[col, col] = beta;
+                for(std::size_t next{col + 1}; next < end; ++next)
+                {
+                    updates[next - col] = tau[col] * (a[col, next] + scale * sums[next - col]);
+                    a[col, next] -= updates[next - col];
+                }
+                for(std::size_t row{col + 1}; row < rows; ++row)
+                {
+                    a[row, col] *= scale;
+                    const Type lead{a[row, col]};
+                    for(std::size_t next{col + 1}; next < end; ++next)
+                    {
+                        a[row, next] -= updates[next - col] * lead;
+                    }
+                }
+            }
+
+            const auto reflectors{panel_reflectors(start, width)};
+            DynamicMatrix<Type, Allocator> gram{width, width, memory};
+            multiply_transposed_into(matrix_view(reflectors), matrix_view(reflectors), matrix_view(gram));
+            DynamicMatrix<Type, Allocator> factor{width, width, memory};
+            for(std::size_t col{0}; col < width; ++col)
+            {
+                factor[col, col] = tau[start + col];
+                for(std::size_t row{0}; row < col; ++row)
+                {
+                    Type sum{0};
+                    for(std::size_t inner{row}; inner < col; ++inner)
+                    {
+                        sum += factor[row, inner] * gram[inner, col];
+                    }
+                    factor[row, col] = -tau[start + col] * sum;
+                }
+            }
+            if(start + width < cols)
+            {
+                apply_block_reflector(matrix_view(reflectors), factor, a.block(start, start + width, rows - start, cols - start - width), true);
+            }
+            factors.push_back(std::move(factor));
+        }
+
+        QrFactorization<Type, Allocator> result{DynamicMatrix<Type, Allocator>{rows, cols, memory}, DynamicMatrix<Type, Allocator>{cols, cols, memory}};
+        for(std::size_t row{0}; row < cols; ++row)
+        {
+            result.q[row, row] = Type{1};
+            for(std::size_t col{row}; col < cols; ++col)
+            {
+                result.r[row, col] = a[row, col];
+            }
+        }
+        for(std::size_t panel{factors.size()}; panel-- > 0;)
+        {
+            const std::size_t start{panel * panelWidth};
+            const std::size_t width{std::min(panelWidth, cols - start)};
+            const auto reflectors{panel_reflectors(start, width)};
+            apply_block_reflector(matrix_view(reflectors), factors[panel], matrix_view(result.q).block(start, start, rows - start, cols - start), false);
+        }
+        return result;
+    }
+
+    // One-sided Jacobi SVD of a small matrix with rows >= cols: column pairs are rotated
+    // until all are orthogonal, and the column norms are the singular values. Singular
+    // values come out in decreasing order; u is rows x cols and v is cols x cols.
+    template<typename Type, typename Allocator>
+    SvdResult<Type, Allocator> jacobi_svd(DynamicMatrix<Type, Allocator> matrix)
+    {
+        static_assert(std::is_floating_point_v<Type>, "Jacobi SVD needs a floating point type.");
+        constexpr std::size_t maxSweeps{64};
+        const std::size_t rows{matrix.rows()};
+        const std::size_t cols{matrix.cols()};
+        if(rows < cols)
+        {
+            throw std::invalid_argument{"Error: Jacobi SVD needs at least as many rows as columns."};
+        }
+        const Allocator memory{matrix.get_allocator()};
+        DynamicMatrix<Type, Allocator> rotations{cols, cols, memory};
+        for(std::size_t index{0}; index < cols; ++index)
+        {
+            rotations[index, index] = Type{1};
+        }
+        const auto rotate{[](DynamicMatrix<Type, Allocator>& target, const std::size_t first, const std::size_t second, const Type cosine, const Type sine)
+        {
+            for(std::size_t row{0}; row < target.rows(); ++row)
+            {
+                const Type lhs{target[row, first]};
+                const Type rhs{target[row, second]};
+                target[row, first] = cosine * lhs - sine * rhs;
+                target[row, second] = sine * lhs + cosine * rhs;
+            }
+        }};
+        for(std::size_t sweep{0}; sweep < maxSweeps; ++sweep)
+        {
+            bool rotated{false};
+            for(std::size_t first{0}; first + 1 < cols; ++first)
+            {
+                for(std::size_t second{first + 1}; second < cols; ++second)
+                {
+                    Type alpha{0};
+                    Type beta{0};
+                    Type gamma{0};
+                    for(std::size_t row{0}; row < rows; ++row)
+                    {
+                        alpha += matrix[row, first] * matrix[row, first];
+                        beta += matrix[row, second] * matrix[row, second];
+                        gamma += matrix[row, first] * matrix[row, second];
+                    }
+                    if(std::abs(gamma) <= std::numeric_limits<Type>::epsilon() * std::sqrt(alpha * beta))
+                    {
+                        continue;
+                    }
+                    rotated = true;
+                    const Type zeta{(beta - alpha) / (2 * gamma)};
+                    const Type tangent{std::copysign(Type{1}, zeta) / (std::abs(zeta) + std::sqrt(1 + zeta * zeta))};
+                    const Type cosine{1 / std::sqrt(1 + tangent * tangent)};
+                    rotate(matrix, first, second, cosine, cosine * tangent);
+                    rotate(rotations, first, second, cosine, cosine * tangent);
+                }
+            }
+            if(!rotated)
+            {
+                break;
+            }
+        }
+
+        std::vector<Type> norms(cols);
+        for(std::size_t col{0}; col < cols; ++col)
+        {
+            Type sum{0};
+            for(std::size_t row{0}; row < rows; ++row)
+            {
+                sum += matrix[row, col] * matrix[row, col];
+            }
+            norms[col] = std::sqrt(sum);
+        }
+        std::vector<std::size_t> order(cols);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs)
+        {
+            return norms[lhs] > norms[rhs];
+        });
+        SvdResult<Type, Allocator> result{DynamicMatrix<Type, Allocator>{rows, cols, memory}, std::vector<Type>(cols), DynamicMatrix<Type, Allocator>{cols, cols, memory}};
+        for(std::size_t col{0}; col < cols; ++col)
+        {
+            const std::size_t source{order[col]};
+            result.singularValues[col] = norms[source];
+            for(std::size_t row{0}; row < rows; ++row)
+            {
+                result.u[row, col] = norms[source] > Type{0}? matrix[row, source] / norms[source] : Type{0};
+            }
+            for(std::size_t row{0}; row < cols; ++row)
+            {
+                result.v[row, col] = rotations[row, source];
+            }
+        }
+        return result;
+    }
+
+    // Cyclic Jacobi eigensolver for small symmetric matrices; eigenvalues come out in
+    // decreasing order with the matching eigenvectors as columns.
+    template<typename Type, typename Allocator>
+    EigenResult<Type, Allocator> jacobi_eigen(DynamicMatrix<Type, Allocator> matrix)
+    {
+        static_assert(std::is_floating_point_v<Type>, "Jacobi eigensolver needs a floating point type.");
+        constexpr std::size_t maxSweeps{64};
+        const std::size_t order{matrix.rows()};
+        if(order != matrix.cols())
+        {
+            throw std::invalid_argument{"Error: eigensolver needs a square matrix."};
+        }
+        const Allocator memory{matrix.get_allocator()};
+        DynamicMatrix<Type, Allocator> vectors{order, order, memory};
+        for(std::size_t index{0}; index < order; ++index)
+        {
+            vectors[index, index] = Type{1};
+        }
+        Type total{0};
+        for(const auto element : matrix)
+        {
+            total += element * element;
+        }
+        for(std::size_t sweep{0}; sweep < maxSweeps; ++sweep)
+        {
+            Type offDiagonal{0};
+            for(std::size_t row{0}; row < order; ++row)
+            {
+                for(std::size_t col{row + 1}; col < order; ++col)
+                {
+                    offDiagonal += 2 * matrix[row, col] * matrix[row, col];
+                }
+            }
+            if(offDiagonal <= std::numeric_limits<Type>::epsilon() * std::numeric_limits<Type>::epsilon() * total)
+            {
+                break;
+            }
+            for(std::size_t first{0}; first + 1 < order; ++first)
+            {
+                for(std::size_t second{first + 1}; second < order; ++second)
+                {
+                    const Type coupling{matrix[first, second]};
+                    if(coupling == Type{0})
+                    {
+                        continue;
+                    }
+                    const Type theta{(matrix[second, second] - matrix[first, first]) / (2 * coupling)};
+                    const Type tangent{std::copysign(Type{1}, theta) / (std::abs(theta) + std::sqrt(theta * theta + 1))};
+                    const Type cosine{1 / std::sqrt(tangent * tangent + 1)};
+                    const Type sine{tangent * cosine};
+                    for(std::size_t index{0}; index < order; ++index)
+                    {
+                        const Type lhs{matrix[index, first]};
+                        const Type rhs{matrix[index, second]};
+                        matrix[index, first] = cosine * lhs - sine * rhs;
+                        matrix[index, second] = sine * lhs + cosine * rhs;
+                    }
+                    for(std::size_t index{0}; index < order; ++index)
+                    {
+                        const Type lhs{matrix[first, index]};
+                        const Type rhs{matrix[second, index]};
+                        matrix[first, index] = cosine * lhs - sine * rhs;
+                        matrix[second, index] = sine * lhs + cosine * rhs;
+                    }
+                    for(std::size_t index{0}; index < order; ++index)
+                    {
+                        const Type lhs{vectors[index, first]};
+                        const Type rhs{vectors[index, second]};
+                        vectors[index, first] = cosine * lhs - sine * rhs;
+                        vectors[index, second] = sine * lhs + cosine * rhs;
+                    }
+                }
+            }
+        }
+
+        std::vector<std::size_t> ranking(order);
+        std::iota(ranking.begin(), ranking.end(), std::size_t{0});
+        std::stable_sort(ranking.begin(), ranking.end(), [&](std::size_t lhs, std::size_t rhs)
+        {
+            return matrix[lhs, lhs] > matrix[rhs, rhs];
+        });
+        EigenResult<Type, Allocator> result{std::vector<Type>(order), DynamicMatrix<Type, Allocator>{order, order, memory}};
+        for(std::size_t col{0}; col < order; ++col)
+        {
+            result.eigenvalues[col] = matrix[ranking[col], ranking[col]];
+            for(std::size_t row{0}; row < order; ++row)
+            {
+                result.vectors[row, col] = vectors[row, ranking[col]];
+            }
+        }
+        return result;
+    }
+
+    struct RandomizedSvdOptions
+    {
+        // Extra sample columns beyond the rank; they absorb the tail of the spectrum.
+        std::size_t oversampling{10};
+        // Each iteration multiplies by A A^T once more, sharpening slowly decaying spectra.
+        std::size_t powerIterations{2};
+        std::uint64_t seed{0x5eed};
+        std::size_t blockSize{32};
+    };
+
+    // Randomized range finder SVD (Halko, Martinsson and Tropp). A Gaussian sketch of
+    // rank + oversampling columns is pushed through A and A^T, with a QR after every
+    // product to keep the basis well conditioned, which yields Q whose span captures the
+    // top singular subspace. Then A^T Q = Q' R, a Jacobi SVD of the small R gives the
+    // rest, and u = Q V_R, v = Q' U_R. All work on A itself is A * X or A^T * X.
+    template<typename Type, typename Allocator>
+    SvdResult<Type, Allocator> randomized_svd(const DynamicMatrix<Type, Allocator>& matrix, const std::size_t rank,
+                                              const RandomizedSvdOptions& options = RandomizedSvdOptions{})
+    {
+        const std::size_t rows{matrix.rows()};
+        const std::size_t cols{matrix.cols()};
+        if(rank == 0
+           || rank > std::min(rows, cols))
+        {
+            throw std::invalid_argument{"Error: rank must be between 1 and the smaller dimension."};
+        }
+        const Allocator memory{matrix.get_allocator()};
+        const std::size_t samples{std::min(rank + options.oversampling, std::min(rows, cols))};
+        const auto sketch{gaussian_matrix<Type>(cols, samples, options.seed, memory)};
+
+        DynamicMatrix<Type, Allocator> range{rows, samples, memory};
+        DynamicMatrix<Type, Allocator> corange{cols, samples, memory};
+        multiply_into(matrix_view(matrix), matrix_view(sketch), matrix_view(range));
+        auto basis{thin_qr(std::move(range), options.blockSize).q};
+        for(std::size_t iteration{0}; iteration < options.powerIterations; ++iteration)
+        {
+            multiply_transposed_into(matrix_view(matrix), matrix_view(std::as_const(basis)), matrix_view(corange));
+            const auto cobasis{thin_qr(std::move(corange), options.blockSize).q};
+            range = DynamicMatrix<Type, Allocator>{rows, samples, memory};
+            multiply_into(matrix_view(matrix), matrix_view(cobasis), matrix_view(range));
+            basis = thin_qr(std::move(range), options.blockSize).q;
+            corange = DynamicMatrix<Type, Allocator>{cols, samples, memory};
+        }
+
+        multiply_transposed_into(matrix_view(matrix), matrix_view(std::as_const(basis)), matrix_view(corange));
+        auto [cobasis, triangle]{thin_qr(std::move(corange), options.blockSize)};
+        const auto small{jacobi_svd(std::move(triangle))};
+
+        SvdResult<Type, Allocator> result{DynamicMatrix<Type, Allocator>{rows, rank, memory},
+                                          std::vector<Type>(small.singularValues.begin(), small.singularValues.begin() + static_cast<std::ptrdiff_t>(rank)),
+                                          DynamicMatrix<Type, Allocator>{cols, rank, memory}};
+        multiply_into(matrix_view(std::as_const(basis)), matrix_view(small.v).block(0, 0, samples, rank), matrix_view(result.u));
+        multiply_into(matrix_view(std::as_const(cobasis)), matrix_view(small.u).block(0, 0, samples, rank), matrix_view(result.v));
+        return result;
+    }
+
+    struct LanczosOptions
+    {
+        std::size_t blockSize{8};
+        // Krylov basis size; 0 picks max(3 * count, count + 4 * blockSize), capped at the order.
+        std::size_t basisSize{0};
+        std::uint64_t seed{0x5eed};
+    };
+
+    // Block Lanczos for the count largest eigenpairs of a symmetric matrix. Each step
+    // multiplies A by a block of basis vectors, projects the result on the whole basis
+    // (giving a block column of T = Q^T A Q), and orthogonalizes it twice against the
+    // basis before a QR turns it into the next block. Full reorthogonalization keeps the
+    // basis orthonormal, so no spurious copies of converged eigenvalues appear. Ritz
+    // pairs of T are lifted back through Q. There is no restart: the basis size bounds
+    // both memory and accuracy, and a larger basis gives more accurate eigenpairs.
+    template<typename Type, typename Allocator>
+    EigenResult<Type, Allocator> lanczos_eigen(const DynamicMatrix<Type, Allocator>& matrix, const std::size_t count,
+                                               const LanczosOptions& options = LanczosOptions{})
+    {
+        const std::size_t order{matrix.rows()};
+        if(order != matrix.cols())
+        {
+            throw std::invalid_argument{"Error: eigensolver needs a square matrix."};
+        }
+        if(count == 0
+           || count > order)
+        {
+            throw std::invalid_argument{"Error: count must be between 1 and the order."};
+        }
+        const Allocator memory{matrix.get_allocator()};
+        const std::size_t blockSize{std::clamp<std::size_t>(options.blockSize, 1, order)};
+        const std::size_t requested{options.basisSize? options.basisSize : std::max(3 * count, count + 4 * blockSize)};
+        const std::size_t capacity{std::min(requested, order) / blockSize * blockSize};
+        if(capacity < count)
+        {
+            throw std::invalid_argument{"Error: basis too small for the requested eigenpairs."};
+        }
+        Type scale{0};
+        for(const auto element : matrix)
+        {
+            scale += element * element;
+        }
+
+        DynamicMatrix<Type, Allocator> basis{order, capacity, memory};
+        DynamicMatrix<Type, Allocator> projection{capacity, capacity, memory};
+        const MatrixView<Type> basisView{matrix_view(basis)};
+        const auto start{thin_qr(gaussian_matrix<Type>(order, blockSize, options.seed, memory)).q};
+        for(std::size_t row{0}; row < order; ++row)
+        {
+            std::copy_n(&start[row, 0], blockSize, &basisView[row, 0]);
+        }
+
+        std::size_t used{blockSize};
+        DynamicMatrix<Type, Allocator> block{order, blockSize, memory};
+        DynamicMatrix<Type, Allocator> coefficients{capacity, blockSize, memory};
+        // Removes the components of target along the basis, twice, as one pass loses
+        // orthogonality when most of target lies in the basis. With record set, the first
+        // pass's coefficients are the new block column of the projection.
+        const auto orthogonalize{[&](DynamicMatrix<Type, Allocator>& target, const bool record)
+        {
+            const MatrixView<const Type> known{basisView.block(0, 0, order, used)};
+            const MatrixView<Type> weights{matrix_view(coefficients).block(0, 0, used, blockSize)};
+            for(std::size_t pass{0}; pass < 2; ++pass)
+            {
+                multiply_transposed_into(known, matrix_view(std::as_const(target)), weights);
+                for(std::size_t row{0}; row < used; ++row)
+                {
+                    for(std::size_t col{0}; col < blockSize; ++col)
+                    {
+                        if(record
+                           && pass == 0)
+                        {
+                            projection[row, used - blockSize + col] = weights[row, col];
+                            projection[used - blockSize + col, row] = weights[row, col];
+                        }
+                        weights[row, col] = -weights[row, col];
+                    }
+                }
+                multiply_into(known, weights, matrix_view(target), true);
+            }
+        }};
+        const Type deficient{std::sqrt(scale * std::numeric_limits<Type>::epsilon())};
+        while(true)
+        {
+            multiply_into(matrix_view(matrix), basisView.block(0, used - blockSize, order, blockSize), matrix_view(block));
+            orthogonalize(block, true);
+            if(used + blockSize > capacity)
+            {
+                break;
+            }
+            // Once the Krylov space stops growing in some direction, QR fills the missing
+            // columns with vectors that need not be orthogonal to the basis; orthogonalizing
+            // again turns them into fresh directions.
+            auto [next, triangle]{thin_qr(block)};
+            Type smallest{std::numeric_limits<Type>::max()};
+            for(std::size_t index{0}; index < blockSize; ++index)
+            {
+                smallest = std::min(smallest, std::abs(triangle[index, index]));
+            }
+            if(smallest <= deficient)
+            {
+                orthogonalize(next, false);
+                next = thin_qr(std::move(next)).q;
+            }
+            for(std::size_t row{0}; row < order; ++row)
+            {
+                std::copy_n(&next[row, 0], blockSize, &basisView[row, used]);
+            }
+            used += blockSize;
+        }
+
+        DynamicMatrix<Type, Allocator> reduced{used, used, memory};
+        for(std::size_t row{0}; row < used; ++row)
+        {
+            std::copy_n(&projection[row, 0], used, &reduced[row, 0]);
+        }
+        const auto ritz{jacobi_eigen(std::move(reduced))};
+        EigenResult<Type, Allocator> result{std::vector<Type>(ritz.eigenvalues.begin(), ritz.eigenvalues.begin() + static_cast<std::ptrdiff_t>(count)),
+                                            DynamicMatrix<Type, Allocator>{order, count, memory}};
+        multiply_into(basisView.block(0, 0, order, used), matrix_view(ritz.vectors).block(0, 0, used, count), matrix_view(result.vectors));
+        return result;
+    }
+}
+
+#endif
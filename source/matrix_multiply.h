@@ -0,0 +1,422 @@
+#ifndef MATRIX_MULTIPLY_H
+#define MATRIX_MULTIPLY_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include "dynamic_matrix.h"
+
+namespace algo
+{
+    // A rows x cols window into row-major storage whose rows are stride elements apart.
+    // Blocks of a view are views again, which is all the recursive products need.
+    template<typename Type>
+    struct MatrixView
+    {
+        using size_type = std::size_t;
+
+        constexpr MatrixView(Type* data, const size_type rows, const size_type cols, const size_type stride) noexcept
+            : data{data}, rows{rows}
+            , cols{cols}, stride{stride}
+        {
+        }
+
+        template<typename Other>
+            requires(std::is_same_v<const Other, Type> && !std::is_same_v<Other, Type>)
+        constexpr MatrixView(const MatrixView<Other>& that) noexcept
+            : data{that.data}, rows{that.rows}
+            , cols{that.cols}, stride{that.stride}
+        {
+        }
+
+        constexpr Type& operator[](const size_type row, const size_type col) const noexcept
+        {
+            return data[row * stride + col];
+        }
+
+        constexpr MatrixView block(const size_type row, const size_type col, const size_type blockRows, const size_type blockCols) const noexcept
+        {
+            return MatrixView{data + row * stride + col, blockRows, blockCols, stride};
+        }
+
+        Type* data;
+        size_type rows;
+        size_type cols;
+        size_type stride;
+    };
+
+    template<typename Type, typename Allocator>
+    MatrixView<Type> matrix_view(DynamicMatrix<Type, Allocator>& matrix) noexcept
+    {
+        return MatrixView<Type>{std::to_address(matrix.data()), matrix.rows(), matrix.cols(), matrix.cols()};
+    }
+
+    template<typename Type, typename Allocator>
+    MatrixView<const Type> matrix_view(const DynamicMatrix<Type, Allocator>& matrix) noexcept
+    {
+        return MatrixView<const Type>{std::to_address(matrix.data()), matrix.rows(), matrix.cols(), matrix.cols()};
+    }
+
+    // Classical product out = lhs * rhs, or out += lhs * rhs when accumulate is set. The
+    // inner and column loops are tiled so a panel of rhs stays in cache while every row
+    // of lhs streams past it, and the innermost loop runs along contiguous rows.
+    template<typename Type>
+    void multiply_into(const std::type_identity_t<MatrixView<const Type>> lhs, const std::type_identity_t<MatrixView<const Type>> rhs,
+                       const MatrixView<Type> out, const bool accumulate = false)
+    {
+        constexpr std::size_t innerBlock{128};
+        constexpr std::size_t colBlock{512};
+        if(!accumulate)
+        {
+            for(std::size_t row{0}; row < out.rows; ++row)
+            {
+                std::fill_n(&out[row, 0], out.cols, Type{});
+            }
+        }
+        for(std::size_t innerStart{0}; innerStart < lhs.cols; innerStart += innerBlock)
+        {
+            const std::size_t innerEnd{std::min(lhs.cols, innerStart + innerBlock)};
+            for(std::size_t colStart{0}; colStart < out.cols; colStart += colBlock)
+            {
+                const std::size_t width{std::min(out.cols - colStart, colBlock)};
+                for(std::size_t row{0}; row < out.rows; ++row)
+                {
+                    Type* target{&out[row, colStart]};
+                    for(std::size_t inner{innerStart}; inner < innerEnd; ++inner)
+                    {
+                        const Type scale{lhs[row, inner]};
+                        const Type* source{&rhs[inner, colStart]};
+                        for(std::size_t col{0}; col < width; ++col)
+                        {
+                            target[col] += scale * source[col];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // out = lhs^T * rhs, or out += lhs^T * rhs. lhs and rhs share their row count, which
+    // is usually the long dimension, so each row contributes a rank-one update to out and
+    // both operands are still read along their rows.
+    template<typename Type>
+    void multiply_transposed_into(const std::type_identity_t<MatrixView<const Type>> lhs, const std::type_identity_t<MatrixView<const Type>> rhs,
+                                  const MatrixView<Type> out, const bool accumulate = false)
+    {
+        constexpr std::size_t colBlock{512};
+        if(!accumulate)
+        {
+            for(std::size_t row{0}; row < out.rows; ++row)
+            {
+                std::fill_n(&out[row, 0], out.cols, Type{});
+            }
+        }
+        for(std::size_t colStart{0}; colStart < out.cols; colStart += colBlock)
+        {
+            const std::size_t width{std::min(out.cols - colStart, colBlock)};
+            for(std::size_t row{0}; row < lhs.rows; ++row)
+            {
+                const Type* source{&rhs[row, colStart]};
+                for(std::size_t outRow{0}; outRow < lhs.cols; ++outRow)
+                {
+                    const Type scale{lhs[row, outRow]};
+                    Type* target{&out[outRow, colStart]};
+                    for(std::size_t col{0}; col < width; ++col)
+                    {
+                        target[col] += scale * source[col];
+                    }
+                }
+            }
+        }
+    }
+
+    struct StrassenOptions
+    {
+        // One level spawns seven products and two levels forty-nine; extra levels cost
+        // workspace, so stop once there is roughly a product per core.
+        static std::size_t default_parallel_depth() noexcept
+        {
+            const unsigned cores{std::thread::hardware_concurrency()};
+            return cores <= 1? 0 : cores <= 7? 1 : 2;
+        }
+
+        // Products with any dimension at or below cutoff use the classical kernel. Below
+        // about 128 the extra additions and cache misses cost more than the saved product.
+        std::size_t cutoff{128};
+        // The first parallelDepth levels run their seven products concurrently.
+        std::size_t parallelDepth{default_parallel_depth()};
+    };
+
+    // Strassen-Winograd: seven half-size products and fifteen additions per level. Odd
+    // dimensions are peeled, so the recursion works on the even part and the leftover
+    // row, column and rank-one update go to the classical kernel. Sequential levels use
+    // the two-temporary schedule of Boyer, Dumas, Pernet and Zhou, which keeps every
+    // intermediate in out or in X and Y. Parallel levels give each product its own
+    // buffers. All of it is carved from one workspace of workspace_size() elements.
+    template<typename Type>
+    class StrassenMultiplier
+    {
+    public:
+        using size_type = std::size_t;
+        using view_type = MatrixView<Type>;
+        using const_view_type = MatrixView<const Type>;
+
+        explicit StrassenMultiplier(const StrassenOptions& options = StrassenOptions{}) noexcept
+            : options{options}
+        {
+        }
+
+        size_type workspace_size(const size_type rows, const size_type inner, const size_type cols) const noexcept
+        {
+            return workspace_size(rows, inner, cols, 0);
+        }
+
+        // out = lhs * rhs; out must not overlap the operands.
+        void multiply(const const_view_type lhs, const const_view_type rhs, const view_type out, Type* workspace) const
+        {
+            multiply(lhs, rhs, out, workspace, 0);
+        }
+    private:
+        bool is_base_case(const size_type rows, const size_type inner, const size_type cols) const noexcept
+        {
+            return std::min({rows, inner, cols}) <= std::max(options.cutoff, size_type{1});
+        }
+
+        size_type workspace_size(const size_type rows, const size_type inner, const size_type cols, const size_type depth) const noexcept
+        {
+            if(is_base_case(rows, inner, cols))
+            {
+                return 0;
+            }
+            const size_type halfRows{rows / 2};
+            const size_type halfInner{inner / 2};
+            const size_type halfCols{cols / 2};
+            const size_type below{workspace_size(halfRows, halfInner, halfCols, depth + 1)};
+            if(depth < options.parallelDepth)
+            {
+                return 4 * halfRows * halfInner + 4 * halfInner * halfCols + 7 * halfRows * halfCols + 7 * below;
+            }
+            return halfRows * std::max(halfInner, halfCols) + halfInner * halfCols + below;
+        }
+
+        void multiply(const const_view_type lhs, const const_view_type rhs, const view_type out, Type* workspace, const size_type depth) const
+        {
+            const size_type rows{lhs.rows};
+            const size_type inner{lhs.cols};
+            const size_type cols{rhs.cols};
+            if(is_base_case(rows, inner, cols))
+            {
+                multiply_into(lhs, rhs, out);
+                return;
+            }
+            const size_type evenRows{rows & ~size_type{1}};
+            const size_type evenInner{inner & ~size_type{1}};
+            const size_type evenCols{cols & ~size_type{1}};
+            const const_view_type evenLhs{lhs.block(0, 0, evenRows, evenInner)};
+            const const_view_type evenRhs{rhs.block(0, 0, evenInner, evenCols)};
+            const view_type evenOut{out.block(0, 0, evenRows, evenCols)};
+            if(depth < options.parallelDepth)
+            {
+                multiply_parallel(evenLhs, evenRhs, evenOut, workspace, depth);
+            }
+            else
+            {
+                multiply_sequential(evenLhs, evenRhs, evenOut, workspace, depth);
+            }
+            if(inner != evenInner)
+            {
+                multiply_into(lhs.block(0, evenInner, evenRows, 1), rhs.block(evenInner, 0, 1, evenCols), evenOut, true);
+            }
+            if(cols != evenCols)
+            {
+                multiply_into(lhs.block(0, 0, evenRows, inner), rhs.block(0, evenCols, inner, 1), out.block(0, evenCols, evenRows, 1));
+            }
+            if(rows != evenRows)
+            {
+                multiply_into(lhs.block(evenRows, 0, 1, inner), rhs, out.block(evenRows, 0, 1, cols));
+            }
+        }
+
+        template<typename Operation>
+        static void combine(const const_view_type lhs, const const_view_type rhs, const view_type out, Operation operation)
+        {
+            for(size_type row{0}; row < out.rows; ++row)
+            {
+                const Type* left{&lhs[row, 0]};
+                const Type* right{&rhs[row, 0]};
+                Type* target{&out[row, 0]};
+                for(size_type col{0}; col < out.cols; ++col)
+                {
+                    target[col] = operation(left[col], right[col]);
+                }
+            }
+        }
+
+        static void add(const const_view_type lhs, const const_view_type rhs, const view_type out)
+        {
+            combine(lhs, rhs, out, std::plus<Type>{});
+        }
+
+        static void subtract(const const_view_type lhs, const const_view_type rhs, const view_type out)
+        {
+            combine(lhs, rhs, out, std::minus<Type>{});
+        }
+
+        void multiply_sequential(const const_view_type lhs, const const_view_type rhs, const view_type out, Type* workspace, const size_type depth) const
+        {
+            const size_type halfRows{lhs.rows / 2};
+            const size_type halfInner{lhs.cols / 2};
+            const size_type halfCols{rhs.cols / 2};
+            const const_view_type a11{lhs.block(0, 0, halfRows, halfInner)};
+            const const_view_type a12{lhs.block(0, halfInner, halfRows, halfInner)};
+            const const_view_type a21{lhs.block(halfRows, 0, halfRows, halfInner)};
+            const const_view_type a22{lhs.block(halfRows, halfInner, halfRows, halfInner)};
+            const const_view_type b11{rhs.block(0, 0, halfInner, halfCols)};
+            const const_view_type b12{rhs.block(0, halfCols, halfInner, halfCols)};
+            const const_view_type b21{rhs.block(halfInner, 0, halfInner, halfCols)};
+            const const_view_type b22{rhs.block(halfInner, halfCols, halfInner, halfCols)};
+            const view_type c11{out.block(0, 0, halfRows, halfCols)};
+            const view_type c12{out.block(0, halfCols, halfRows, halfCols)};
+            const view_type c21{out.block(halfRows, 0, halfRows, halfCols)};
+            const view_type c22{out.block(halfRows, halfCols, halfRows, halfCols)};
+            const view_type x{workspace, halfRows, halfInner, halfInner};
+            const view_type product{workspace, halfRows, halfCols, halfCols};
+            Type* const yStart{workspace + halfRows * std::max(halfInner, halfCols)};
+            const view_type y{yStart, halfInner, halfCols, halfCols};
+            Type* const below{yStart + halfInner * halfCols};
+
+            subtract(a11, a21, x);
+            subtract(b22, b12, y);
+            multiply(x, y, c21, below, depth + 1);
+            add(a21, a22, x);
+            subtract(b12, b11, y);
+            multiply(x, y, c22, below, depth + 1);
+            subtract(x, a11, x);
+            subtract(b22, y, y);
+            multiply(x, y, c12, below, depth + 1);
+            subtract(a12, x, x);
+            multiply(x, b22, c11, below, depth + 1);
+            multiply(a11, b11, product, below, depth + 1);
+            add(product, c12, c12);
+            add(c12, c21, c21);
+            add(c12, c22, c12);
+            add(c21, c22, c22);
+            add(c12, c11, c12);
+            subtract(y, b21, y);
+            multiply(a22, y, c11, below, depth + 1);
+            subtract(c21, c11, c21);
+            multiply(a12, b21, c11, below, depth + 1);
+            add(product, c11, c11);
+        }
+
+        void multiply_parallel(const const_view_type lhs, const const_view_type rhs, const view_type out, Type* workspace, const size_type depth) const
+        {
+            const size_type halfRows{lhs.rows / 2};
+            const size_type halfInner{lhs.cols / 2};
+            const size_type halfCols{rhs.cols / 2};
+            const const_view_type a11{lhs.block(0, 0, halfRows, halfInner)};
+            const const_view_type a12{lhs.block(0, halfInner, halfRows, halfInner)};
+            const const_view_type a21{lhs.block(halfRows, 0, halfRows, halfInner)};
+            const const_view_type a22{lhs.block(halfRows, halfInner, halfRows, halfInner)};
+            const const_view_type b11{rhs.block(0, 0, halfInner, halfCols)};
+            const const_view_type b12{rhs.block(0, halfCols, halfInner, halfCols)};
+            const const_view_type b21{rhs.block(halfInner, 0, halfInner, halfCols)};
+            const const_view_type b22{rhs.block(halfInner, halfCols, halfInner, halfCols)};
+            Type* next{workspace};
+            auto take{[&](const size_type rows, const size_type cols)
+            {
+                const view_type view{next, rows, cols, cols};
+                next += rows * cols;
+                return view;
+            }};
+            const view_type s1{take(halfRows, halfInner)};
+            const view_type s2{take(halfRows, halfInner)};
+            const view_type s3{take(halfRows, halfInner)};
+            const view_type s4{take(halfRows, halfInner)};
+            const view_type t1{take(halfInner, halfCols)};
+            const view_type t2{take(halfInner, halfCols)};
+            const view_type t3{take(halfInner, halfCols)};
+            const view_type t4{take(halfInner, halfCols)};
+            const std::array<view_type, 7> products{take(halfRows, halfCols), take(halfRows, halfCols), take(halfRows, halfCols), take(halfRows, halfCols),
+                                                    take(halfRows, halfCols), take(halfRows, halfCols), take(halfRows, halfCols)};
+            add(a21, a22, s1);
+            subtract(s1, a11, s2);
+            subtract(a11, a21, s3);
+            subtract(a12, s2, s4);
+            subtract(b12, b11, t1);
+            subtract(b22, t1, t2);
+            subtract(b22, b12, t3);
+            subtract(t2, b21, t4);
+
+            const std::array<std::pair<const_view_type, const_view_type>, 7> operands{{{a11, b11}, {a12, b21}, {s4, b22}, {a22, t4},
+                                                                                       {s1, t1}, {s2, t2}, {s3, t3}}};
+            const size_type slice{workspace_size(halfRows, halfInner, halfCols, depth + 1)};
+            std::array<std::future<void>, 6> tasks;
+            for(size_type index{1}; index < 7; ++index)
+            {
+                tasks[index - 1] = std::async(std::launch::async, [&, index]
+                {
+                    multiply(operands[index].first, operands[index].second, products[index], next + index * slice, depth + 1);
+                });
+            }
+            multiply(operands[0].first, operands[0].second, products[0], next, depth + 1);
+            for(auto& task : tasks)
+            {
+                task.get();
+            }
+
+            const view_type c11{out.block(0, 0, halfRows, halfCols)};
+            const view_type c12{out.block(0, halfCols, halfRows, halfCols)};
+            const view_type c21{out.block(halfRows, 0, halfRows, halfCols)};
+            const view_type c22{out.block(halfRows, halfCols, halfRows, halfCols)};
+            add(products[0], products[1], c11);
+            add(products[0], products[5], c12);
+            add(c12, products[6], c21);
+            add(c21, products[4], c22);
+            subtract(c21, products[3], c21);
+            add(c12, products[4], c12);
+            add(c12, products[2], c12);
+        }
+
+        StrassenOptions options;
+    };
+
+    template<typename Type, typename Allocator>
+    void check_product_shape(const DynamicMatrix<Type, Allocator>& lhs, const DynamicMatrix<Type, Allocator>& rhs)
+    {
+        if(lhs.cols() != rhs.rows())
+        {
+            throw std::invalid_argument{"Error: inner dimensions do not match."};
+        }
+    }
+
+    template<typename Type, typename Allocator>
+    DynamicMatrix<Type, Allocator> multiply(const DynamicMatrix<Type, Allocator>& lhs, const DynamicMatrix<Type, Allocator>& rhs)
+    {
+        check_product_shape(lhs, rhs);
+        DynamicMatrix<Type, Allocator> product{lhs.rows(), rhs.cols(), lhs.get_allocator()};
+        multiply_into(matrix_view(lhs), matrix_view(rhs), matrix_view(product));
+        return product;
+    }
+
+    // The workspace comes from lhs's allocator in a single allocation.
+    template<typename Type, typename Allocator>
+    DynamicMatrix<Type, Allocator> strassen_multiply(const DynamicMatrix<Type, Allocator>& lhs, const DynamicMatrix<Type, Allocator>& rhs,
+                                                     const StrassenOptions& options = StrassenOptions{})
+    {
+        check_product_shape(lhs, rhs);
+        const StrassenMultiplier<Type> multiplier{options};
+        DynamicMatrix<Type, Allocator> product{lhs.rows(), rhs.cols(), lhs.get_allocator()};
+        DynamicMatrix<Type, Allocator> workspace{1, multiplier.workspace_size(lhs.rows(), lhs.cols(), rhs.cols()), lhs.get_allocator()};
+        multiplier.multiply(matrix_view(lhs), matrix_view(rhs), matrix_view(product), std::to_address(workspace.data()));
+        return product;
+    }
+}
+
+#endif
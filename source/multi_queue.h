@@ -0,0 +1,199 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace algo
+{
+    // Relaxed concurrent priority queue: keys are spread over several sequential heaps,
+    // each behind its own lock. push goes to a random lane and pop takes the better top
+    // of two random lanes, so a pop returns a key close to, but not always exactly, the
+    // minimum; with c lanes per thread the expected rank error grows linearly in c times
+    // the thread count. Lanes are only ever try-locked, which is why no lock order is needed.
+    template<typename Key,
+             typename Compare = std::less<Key>>
+    class MultiQueue
+    {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+
+        static constexpr size_type lanesPerThread{2};
+
+        MultiQueue()
+            : MultiQueue{lanesPerThread * std::max(1u, std::thread::hardware_concurrency())}
+        {
+        }
+
+        explicit MultiQueue(size_type laneCount, const key_compare& compare = key_compare{})
+            : lanes{}, laneCount{laneCount}
+            , count{0}, compare{compare}
+        {
+            if(laneCount == 0)
+            {
+                throw std::invalid_argument{"Error: a multi queue needs at least one lane."};
+            }
+            lanes = std::make_unique<Lane[]>(laneCount);
+        }
+
+        MultiQueue(const MultiQueue&) = delete;
+        MultiQueue& operator=(const MultiQueue&) = delete;
+
+        void push(const key_type& key)
+        {
+            emplace(key);
+        }
+
+        void push(key_type&& key)
+        {
+            emplace(std::move(key));
+        }
+
+        template<typename... Args>
+        void emplace(Args&&... args)
+        {
+            while(true)
+            {
+                Lane& lane{lanes[random_lane()]};
+                std::unique_lock lock{lane.mutex, std::try_to_lock};
+                if(!lock)
+                {
+                    continue;
+                }
+                lane.keys.emplace_back(std::forward<Args>(args)...);
+                std::push_heap(lane.keys.begin(), lane.keys.end(), reversed());
+                count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        // Returns nothing once the count reads zero, or after a sweep found every lane
+        // it could lock empty; with concurrent pushes that is a hint, not a proof, that
+        // the queue is drained, and callers poll again.
+        std::optional<key_type> try_pop()
+        {
+            for(size_type attempt{0}; attempt < laneCount; ++attempt)
+            {
+                if(count.load(std::memory_order_relaxed) == 0)
+                {
+                    return std::nullopt;
+                }
+                size_type first{random_lane()};
+                size_type second{random_lane()};
+                std::unique_lock firstLock{lanes[first].mutex, std::try_to_lock};
+                if(!firstLock)
+                {
+                    continue;
+                }
+                std::unique_lock secondLock{lanes[second].mutex, std::defer_lock};
+                if(second != first
+                   && !secondLock.try_lock())
+                {
+                    continue;
+                }
+                Lane* best{&lanes[first]};
+                if(second != first
+                   && better(lanes[second], *best))
+                {
+                    best = &lanes[second];
+                }
+                if(!best->keys.empty())
+                {
+                    return take_top(*best);
+                }
+            }
+            return sweep();
+        }
+
+        // Approximate while other threads push or pop.
+        size_type size() const noexcept
+        {
+            return count.load(std::memory_order_relaxed);
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type lane_count() const noexcept
+        {
+            return laneCount;
+        }
+    private:
+        struct alignas(64) Lane
+        {
+            std::mutex mutex;
+            std::vector<key_type> keys;
+        };
+
+        auto reversed() const
+        {
+            return [this](const key_type& left, const key_type& right)
+            {
+                return compare(right, left);
+            };
+        }
+
+        bool better(const Lane& candidate, const Lane& current) const
+        {
+            if(candidate.keys.empty())
+            {
+                return false;
+            }
+            return current.keys.empty()
+                   || compare(candidate.keys.front(), current.keys.front());
+        }
+
+        key_type take_top(Lane& lane)
+        {
+            std::pop_heap(lane.keys.begin(), lane.keys.end(), reversed());
+            key_type top{std::move(lane.keys.back())};
+            lane.keys.pop_back();
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return top;
+        }
+
+        // Lanes another thread holds are skipped rather than waited for, so an idle
+        // thread never queues up behind the workers that still have keys.
+        std::optional<key_type> sweep()
+        {
+            for(size_type index{0}; index < laneCount; ++index)
+            {
+                std::unique_lock lock{lanes[index].mutex, std::try_to_lock};
+                if(lock
+                   && !lanes[index].keys.empty())
+                {
+                    return take_top(lanes[index]);
+                }
+            }
+            return std::nullopt;
+        }
+
+        size_type random_lane() const
+        {
+            thread_local std::minstd_rand engine{static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+            return engine() % laneCount;
+        }
+
+        std::unique_ptr<Lane[]> lanes;
+        size_type laneCount;
+        std::atomic<size_type> count;
+        key_compare compare;
+    };
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace algo
+{
+    // Hands out node storage from geometrically growing chunks and recycles released
+    // slots through an intrusive free list. Nodes never move, so pointers to them stay
+    // valid until they are destroyed, even across splice(). The free list also tracks
+    // its tail, so splice() chains the donor's list on in constant time.
+    template<typename Node>
+    class NodePool
+    {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr size_type firstChunkNodes{32};
+        static constexpr size_type maxChunkNodes{4096};
+
+        NodePool() noexcept
+            : chunks{}, freeList{nullptr}
+            , freeTail{nullptr}, nextChunkNodes{firstChunkNodes}
+        {
+        }
+
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        NodePool(NodePool&& that) noexcept
+            : chunks{std::move(that.chunks)}, freeList{that.freeList}
+            , freeTail{that.freeTail}, nextChunkNodes{that.nextChunkNodes}
+        {
+            that.freeList = nullptr;
+            that.freeTail = nullptr;
+            that.nextChunkNodes = firstChunkNodes;
+        }
+
+        NodePool& operator=(NodePool&& that) noexcept
+        {
+            NodePool{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        template<typename... Args>
+        Node* create(Args&&... args)
+        {
+            if(freeList == nullptr)
+            {
+                grow();
+            }
+            Slot* slot{freeList};
+            freeList = slot->next;
+            try
+            {
+                return std::construct_at(reinterpret_cast<Node*>(slot->storage), std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                push_free(slot);
+                throw;
+            }
+        }
+
+        void destroy(Node* node) noexcept
+        {
+            std::destroy_at(node);
+            push_free(reinterpret_cast<Slot*>(node));
+        }
+
+        // Takes over the chunks of that; nodes still alive in them now belong to this pool.
+        void splice(NodePool& that)
+        {
+            chunks.reserve(chunks.size() + that.chunks.size());
+            std::move(that.chunks.begin(), that.chunks.end(), std::back_inserter(chunks));
+            that.chunks.clear();
+            if(that.freeList)
+            {
+                that.freeTail->next = freeList;
+                if(freeList == nullptr)
+                {
+                    freeTail = that.freeTail;
+                }
+                freeList = that.freeList;
+                that.freeList = nullptr;
+                that.freeTail = nullptr;
+            }
+            nextChunkNodes = std::max(nextChunkNodes, that.nextChunkNodes);
+            that.nextChunkNodes = firstChunkNodes;
+        }
+
+        void swap(NodePool& that) noexcept
+        {
+            std::swap(this->chunks, that.chunks);
+            std::swap(this->freeList, that.freeList);
+            std::swap(this->freeTail, that.freeTail);
+            std::swap(this->nextChunkNodes, that.nextChunkNodes);
+        }
+    private:
+        union Slot
+        {
+            Slot* next;
+            alignas(Node) std::byte storage[sizeof(Node)];
+        };
+
+        void push_free(Slot* slot) noexcept
+        {
+            slot->next = freeList;
+            if(freeList == nullptr)
+            {
+                freeTail = slot;
+            }
+            freeList = slot;
+        }
+
+        void grow()
+        {
+            auto chunk{std::make_unique<Slot[]>(nextChunkNodes)};
+            for(size_type index{0}; index < nextChunkNodes; ++index)
+            {
+                chunk[index].next = index + 1 < nextChunkNodes? &chunk[index + 1] : freeList;
+            }
+            if(freeList == nullptr)
+            {
+                freeTail = &chunk[nextChunkNodes - 1];
+            }
+            freeList = &chunk[0];
+            chunks.push_back(std::move(chunk));
+            nextChunkNodes = std::min(nextChunkNodes * 2, maxChunkNodes);
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> chunks;
+        Slot* freeList;
+        // Only meaningful while freeList is non-null; whatever empties the list leaves it
+        // stale, and whatever refills an empty list sets it again.
+        Slot* freeTail;
+        size_type nextChunkNodes;
+    };
+}
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef OUT_OF_CORE_MULTIPLY_H
+#define OUT_OF_CORE_MULTIPLY_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "dynamic_matrix.h"
+#include "matrix_multiply.h"
+
+namespace algo
+{
+    // A matrix on disk as a grid of tileSize x tileSize tiles after a header of three
+    // 64-bit words (rows, cols, tileSize). Each tile is row-major and contiguous, tiles
+    // follow each other row of tiles by row of tiles, and edge tiles are padded with
+    // zeros, so a run of tiles in one tile row is a single sequential read or write.
+    template<typename Type>
+    class TiledMatrixFile
+    {
+        static_assert(std::is_trivially_copyable_v<Type>, "Tiles are read and written as raw bytes.");
+    public:
+        using value_type = Type;
+        using size_type = std::size_t;
+
+        static TiledMatrixFile create(const std::filesystem::path& path, const size_type rows, const size_type cols, const size_type tileSize)
+        {
+            if(tileSize == 0)
+            {
+                throw std::invalid_argument{"Error: tile size must be positive."};
+            }
+            {
+                std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+                const std::array<std::uint64_t, 3> header{rows, cols, tileSize};
+                stream.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+                if(!stream)
+                {
+                    throw std::runtime_error{"Error: cannot create " + path.string()};
+                }
+            }
+            TiledMatrixFile file{path, std::ios::in | std::ios::out};
+            std::filesystem::resize_file(path, headerBytes + file.tile_rows() * file.tile_cols() * file.tile_bytes());
+            return file;
+        }
+
+        explicit TiledMatrixFile(const std::filesystem::path& path, const std::ios::openmode mode = std::ios::in)
+            : stream{path, mode | std::ios::binary}
+            , rowsNumber{0}, colsNumber{0}, tileSize{0}
+        {
+            std::array<std::uint64_t, 3> header{};
+            stream.read(reinterpret_cast<char*>(header.data()), sizeof(header));
+            if(!stream
+               || header[2] == 0)
+            {
+                throw std::runtime_error{"Error: cannot read tiled matrix " + path.string()};
+            }
+            rowsNumber = header[0];
+            colsNumber = header[1];
+            tileSize = header[2];
+        }
+
+        size_type rows() const noexcept
+        {
+            return rowsNumber;
+        }
+
+        size_type cols() const noexcept
+        {
+            return colsNumber;
+        }
+
+        size_type tile_size() const noexcept
+        {
+            return tileSize;
+        }
+
+        size_type tile_rows() const noexcept
+        {
+            return (rowsNumber + tileSize - 1) / tileSize;
+        }
+
+        size_type tile_cols() const noexcept
+        {
+            return (colsNumber + tileSize - 1) / tileSize;
+        }
+
+        size_type tile_elements() const noexcept
+        {
+            return tileSize * tileSize;
+        }
+
+        size_type tile_bytes() const noexcept
+        {
+            return tile_elements() * sizeof(Type);
+        }
+
+        // Reads count tiles starting at (tileRow, tileCol) into consecutive tile slots of out.
+        void read_tiles(const size_type tileRow, const size_type tileCol, const size_type count, Type* out)
+        {
+            check_tiles(tileRow, tileCol, count);
+            stream.seekg(static_cast<std::streamoff>(offset(tileRow, tileCol)));
+            stream.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * tile_bytes()));
+            if(!stream)
+            {
+                throw std::runtime_error{"Error: short read from tiled matrix."};
+            }
+        }
+
+        void write_tiles(const size_type tileRow, const size_type tileCol, const size_type count, const Type* in)
+        {
+            check_tiles(tileRow, tileCol, count);
+            stream.seekp(static_cast<std::streamoff>(offset(tileRow, tileCol)));
+            stream.write(reinterpret_cast<const char*>(in), static_cast<std::streamsize>(count * tile_bytes()));
+            if(!stream)
+            {
+                throw std::runtime_error{"Error: short write to tiled matrix."};
+            }
+        }
+
+        void flush()
+        {
+            stream.flush();
+        }
+    private:
+        static constexpr size_type headerBytes{3 * sizeof(std::uint64_t)};
+
+        void check_tiles(const size_type tileRow, const size_type tileCol, const size_type count) const
+        {
+            if(tileRow >= tile_rows()
+               || tileCol + count > tile_cols())
+            {
+                throw std::out_of_range{"Error: tile outside the matrix."};
+            }
+        }
+
+        size_type offset(const size_type tileRow, const size_type tileCol) const noexcept
+        {
+            return headerBytes + (tileRow * tile_cols() + tileCol) * tile_bytes();
+        }
+
+        std::fstream stream;
+        size_type rowsNumber;
+        size_type colsNumber;
+        size_type tileSize;
+    };
+
+    template<typename Type, typename Allocator>
+    void write_tiled_matrix(const std::filesystem::path& path, const DynamicMatrix<Type, Allocator>& matrix, const std::size_t tileSize)
+    {
+        auto file{TiledMatrixFile<Type>::create(path, matrix.rows(), matrix.cols(), tileSize)};
+        DynamicMatrix<Type> tiles{file.tile_cols() * tileSize, tileSize};
+        for(std::size_t tileRow{0}; tileRow < file.tile_rows(); ++tileRow)
+        {
+            std::fill(tiles.begin(), tiles.end(), Type{});
+            for(std::size_t row{tileRow * tileSize}; row < std::min(matrix.rows(), (tileRow + 1) * tileSize); ++row)
+            {
+                for(std::size_t col{0}; col < matrix.cols(); ++col)
+                {
+                    tiles[col / tileSize * tileSize + row % tileSize, col % tileSize] = matrix[row, col];
+                }
+            }
+            file.write_tiles(tileRow, 0, file.tile_cols(), tiles.data());
+        }
+    }
+
+    template<typename Type>
+    DynamicMatrix<Type> read_tiled_matrix(const std::filesystem::path& path)
+    {
+        TiledMatrixFile<Type> file{path};
+        const std::size_t tileSize{file.tile_size()};
+        DynamicMatrix<Type> matrix{file.rows(), file.cols()};
+        DynamicMatrix<Type> tiles{file.tile_cols() * tileSize, tileSize};
+        for(std::size_t tileRow{0}; tileRow < file.tile_rows(); ++tileRow)
+        {
+            file.read_tiles(tileRow, 0, file.tile_cols(), tiles.data());
+            for(std::size_t row{tileRow * tileSize}; row < std::min(matrix.rows(), (tileRow + 1) * tileSize); ++row)
+            {
+                for(std::size_t col{0}; col < matrix.cols(); ++col)
+                {
+                    matrix[row, col] = tiles[col / tileSize * tileSize + row % tileSize, col % tileSize];
+                }
+            }
+        }
+        return matrix;
+    }
+
+    struct OutOfCoreOptions
+    {
+        // Upper bound on the tile buffers held in memory at once.
+        std::size_t memoryBudget{std::size_t{256} << 20};
+    };
+
+    struct OutOfCoreStats
+    {
+        std::size_t bytesRead{0};
+        std::size_t bytesWritten{0};
+        std::size_t residentBytes{0};
+        double flops{0};
+        double readSeconds{0};
+        double writeSeconds{0};
+        double computeSeconds{0};
+        // Time compute spent waiting for a panel that was not loaded yet.
+        double stallSeconds{0};
+        double elapsedSeconds{0};
+
+        double read_throughput() const noexcept
+        {
+            return readSeconds > 0? static_cast<double>(bytesRead) / readSeconds : 0;
+        }
+
+        double write_throughput() const noexcept
+        {
+            return writeSeconds > 0? static_cast<double>(bytesWritten) / writeSeconds : 0;
+        }
+
+        double compute_throughput() const noexcept
+        {
+            return computeSeconds > 0? flops / computeSeconds : 0;
+        }
+
+        // Share of read time hidden behind compute; 1 means I/O was fully overlapped.
+        double overlap() const noexcept
+        {
+            return readSeconds > 0? std::clamp(1 - stallSeconds / readSeconds, 0.0, 1.0) : 1;
+        }
+    };
+
+    // output = lhs * rhs for tiled files that share a tile size. Output is produced one
+    // block of panelWidth tiles in a tile row at a time. For every inner tile index the
+    // block needs one lhs tile and the panelWidth rhs tiles of that tile row, which are
+    // contiguous on disk. Those panels go through two buffers: while one is multiplied,
+    // the next step's panel is read on another thread. The accumulator and both buffers
+    // take (3 * panelWidth + 2) tiles, and panelWidth is the widest that fits the budget.
+    template<typename Type>
+    OutOfCoreStats out_of_core_multiply(const std::filesystem::path& lhsPath, const std::filesystem::path& rhsPath,
+                                        const std::filesystem::path& outPath, const OutOfCoreOptions& options = OutOfCoreOptions{})
+    {
+        using clock = std::chrono::steady_clock;
+        const auto seconds_since{[](const clock::time_point start)
+        {
+            return std::chrono::duration<double>(clock::now() - start).count();
+        }};
+        const auto started{clock::now()};
+
+        TiledMatrixFile<Type> lhs{lhsPath};
+        TiledMatrixFile<Type> rhs{rhsPath};
+        if(lhs.cols() != rhs.rows())
+        {
+            throw std::invalid_argument{"Error: inner dimensions do not match."};
+        }
+        if(lhs.tile_size() != rhs.tile_size())
+        {
+            throw std::invalid_argument{"Error: operands use different tile sizes."};
+        }
+        const std::size_t tileSize{lhs.tile_size()};
+        const std::size_t tileBytes{lhs.tile_bytes()};
+        if(options.memoryBudget / tileBytes < 5)
+        {
+            throw std::invalid_argument{"Error: memory budget holds fewer than five tiles."};
+        }
+        const std::size_t panelWidth{std::max<std::size_t>(1, std::min(rhs.tile_cols(), (options.memoryBudget / tileBytes - 2) / 3))};
+        auto out{TiledMatrixFile<Type>::create(outPath, lhs.rows(), rhs.cols(), tileSize)};
+
+        struct Step
+        {
+            std::size_t tileRow;
+            std::size_t tileCol;
+            std::size_t width;
+            std::size_t inner;
+        };
+        std::vector<Step> steps;
+        for(std::size_t tileRow{0}; tileRow < lhs.tile_rows(); ++tileRow)
+        {
+            for(std::size_t tileCol{0}; tileCol < rhs.tile_cols(); tileCol += panelWidth)
+            {
+                for(std::size_t inner{0}; inner < lhs.tile_cols(); ++inner)
+                {
+                    steps.push_back(Step{tileRow, tileCol, std::min(panelWidth, rhs.tile_cols() - tileCol), inner});
+                }
+            }
+        }
+
+        // Each buffer stacks its tiles vertically, so tile j is rows [j * tileSize, (j + 1) * tileSize).
+        struct Panel
+        {
+            DynamicMatrix<Type> lhs;
+            DynamicMatrix<Type> rhs;
+        };
+        std::array<Panel, 2> panels{Panel{DynamicMatrix<Type>{tileSize}, DynamicMatrix<Type>{panelWidth * tileSize, tileSize}},
+                                    Panel{DynamicMatrix<Type>{tileSize}, DynamicMatrix<Type>{panelWidth * tileSize, tileSize}}};
+        DynamicMatrix<Type> block{panelWidth * tileSize, tileSize};
+
+        OutOfCoreStats stats{};
+        stats.residentBytes = (3 * panelWidth + 2) * tileBytes;
+        // Only one load is in flight at a time and get() orders it before the next one,
+        // so the loader owns both input streams without locking.
+        const auto load{[&](const Step& step, Panel& panel)
+        {
+            const auto start{clock::now()};
+            lhs.read_tiles(step.tileRow, step.inner, 1, panel.lhs.data());
+            rhs.read_tiles(step.inner, step.tileCol, step.width, panel.rhs.data());
+            return std::pair{(1 + step.width) * tileBytes, seconds_since(start)};
+        }};
+
+        std::future<std::pair<std::size_t, double>> pending;
+        if(!steps.empty())
+        {
+            pending = std::async(std::launch::async, load, std::cref(steps[0]), std::ref(panels[0]));
+        }
+        for(std::size_t index{0}; index < steps.size(); ++index)
+        {
+            const Step& step{steps[index]};
+            Panel& panel{panels[index % 2]};
+            const auto waiting{clock::now()};
+            const auto [bytes, readSeconds]{pending.get()};
+            stats.stallSeconds += seconds_since(waiting);
+            stats.bytesRead += bytes;
+            stats.readSeconds += readSeconds;
+            if(index + 1 < steps.size())
+            {
+                pending = std::async(std::launch::async, load, std::cref(steps[index + 1]), std::ref(panels[(index + 1) % 2]));
+            }
+
+            const auto computing{clock::now()};
+            const MatrixView<const Type> lhsTile{matrix_view(std::as_const(panel.lhs))};
+            const MatrixView<const Type> rhsTiles{matrix_view(std::as_const(panel.rhs))};
+            const MatrixView<Type> blockTiles{matrix_view(block)};
+            for(std::size_t tile{0}; tile < step.width; ++tile)
+            {
+                multiply_into(lhsTile, rhsTiles.block(tile * tileSize, 0, tileSize, tileSize),
+                              blockTiles.block(tile * tileSize, 0, tileSize, tileSize), step.inner != 0);
+            }
+            stats.computeSeconds += seconds_since(computing);
+            stats.flops += 2.0 * static_cast<double>(step.width * tileSize * tileSize * tileSize);
+
+            if(step.inner + 1 == lhs.tile_cols())
+            {
+                const auto writing{clock::now()};
+                out.write_tiles(step.tileRow, step.tileCol, step.width, block.data());
+                stats.writeSeconds += seconds_since(writing);
+                stats.bytesWritten += step.width * tileBytes;
+            }
+        }
+        out.flush();
+        stats.elapsedSeconds = seconds_since(started);
+        return stats;
+    }
+}
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include "addressable_heap.h"
+#include "node_pool.h"
+
+namespace algo
+{
+    template<typename Key>
+    struct PairingHeapNode
+    {
+        template<typename... Args>
+        explicit PairingHeapNode(Args&&... args)
+            : child{nullptr}, sibling{nullptr}
+            , previous{nullptr}, key(std::forward<Args>(args)...)
+        {
+        }
+
+        PairingHeapNode* child;
+        PairingHeapNode* sibling;
+        PairingHeapNode* previous;
+        Key key;
+    };
+
+    // previous points at the parent for a first child and at the left sibling otherwise,
+    // which is all decrease_key needs to cut a subtree out in O(1).
+    template<typename Key,
+             typename Compare = std::less<Key>>
+    class pairing_heap
+    {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using node_type = PairingHeapNode<Key>;
+        using handle = node_type*;
+        using const_reference = const key_type&;
+
+        pairing_heap()
+            : root{nullptr}, count{0}
+            , pool{}, compare{}
+        {
+        }
+
+        explicit pairing_heap(const key_compare& compare)
+            : root{nullptr}, count{0}
+            , pool{}, compare{compare}
+        {
+        }
+
+        pairing_heap(const pairing_heap&) = delete;
+        pairing_heap& operator=(const pairing_heap&) = delete;
+
+        pairing_heap(pairing_heap&& that) noexcept
+            : root{that.root}, count{that.count}
+            , pool{std::move(that.pool)}, compare{std::move(that.compare)}
+        {
+            that.root = nullptr;
+            that.count = 0;
+        }
+
+        pairing_heap& operator=(pairing_heap&& that) noexcept
+        {
+            pairing_heap{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        ~pairing_heap()
+        {
+            clear();
+        }
+
+        template<typename... Args>
+        handle emplace(Args&&... args)
+        {
+            node_type* fresh{pool.create(std::forward<Args>(args)...)};
+            root = meld(root, fresh);
+            ++count;
+            return fresh;
+        }
+
+        handle push(const key_type& key)
+        {
+            return emplace(key);
+        }
+
+        handle push(key_type&& key)
+        {
+            return emplace(std::move(key));
+        }
+
+        const_reference top() const
+        {
+            if(root == nullptr)
+            {
+                throw std::out_of_range{"Error: top of an empty heap."};
+            }
+            return root->key;
+        }
+
+        void pop()
+        {
+            if(root == nullptr)
+            {
+                throw std::out_of_range{"Error: pop of an empty heap."};
+            }
+            node_type* removed{root};
+            root = combine_siblings(removed->child);
+            --count;
+            pool.destroy(removed);
+        }
+
+        void decrease_key(handle node, const key_type& key)
+        {
+            if(compare(node->key, key))
+            {
+                throw std::invalid_argument{"Error: new key is worse than the current one."};
+            }
+            node->key = key;
+            if(node != root)
+            {
+                cut(node);
+                root = meld(root, node);
+            }
+        }
+
+        void erase(handle node)
+        {
+            if(node == root)
+            {
+                pop();
+                return;
+            }
+            cut(node);
+            root = meld(root, combine_siblings(node->child));
+            --count;
+            pool.destroy(node);
+        }
+
+        // Handles from that stay valid and now refer to entries of this heap.
+        void merge(pairing_heap& that)
+        {
+            if(this == &that)
+            {
+                return;
+            }
+            pool.splice(that.pool);
+            root = meld(root, that.root);
+            count += that.count;
+            that.root = nullptr;
+            that.count = 0;
+        }
+
+        void merge(pairing_heap&& that)
+        {
+            merge(that);
+        }
+
+        size_type size() const noexcept
+        {
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        void clear()
+        {
+            destroy_subtree(root);
+            root = nullptr;
+            count = 0;
+        }
+
+        void swap(pairing_heap& that) noexcept
+        {
+            std::swap(this->root, that.root);
+            std::swap(this->count, that.count);
+            this->pool.swap(that.pool);
+            std::swap(this->compare, that.compare);
+        }
+    private:
+        node_type* meld(node_type* first, node_type* second) noexcept
+        {
+            if(first == nullptr)
+            {
+                return second;
+            }
+            if(second == nullptr)
+            {
+                return first;
+            }
+            if(compare(second->key, first->key))
+            {
+                std::swap(first, second);
+            }
+            second->previous = first;
+            second->sibling = first->child;
+            if(first->child)
+            {
+                first->child->previous = second;
+            }
+            first->child = second;
+            first->sibling = nullptr;
+            first->previous = nullptr;
+            return first;
+        }
+
+        // Two-pass pairing without recursion: pairs are melded left to right and pushed
+        // onto a list through sibling links, then that list is melded back to front.
+        node_type* combine_siblings(node_type* first) noexcept
+        {
+            node_type* paired{nullptr};
+            while(first)
+            {
+                node_type* second{first->sibling};
+                if(second == nullptr)
+                {
+                    first->sibling = paired;
+                    paired = first;
+                    break;
+                }
+                node_type* next{second->sibling};
+                first->sibling = nullptr;
+                second->sibling = nullptr;
+                node_type* melded{meld(first, second)};
+                melded->sibling = paired;
+                paired = melded;
+                first = next;
+            }
+            node_type* result{nullptr};
+            while(paired)
+            {
+                node_type* next{paired->sibling};
+                paired->sibling = nullptr;
+                result = meld(result, paired);
+                paired = next;
+            }
+            if(result)
+            {
+                result->previous = nullptr;
+            }
+            return result;
+        }
+
+        static void cut(node_type* node) noexcept
+        {
+            if(node->previous->child == node)
+            {
+                node->previous->child = node->sibling;
+            }
+            else
+            {
+                node->previous->sibling = node->sibling;
+            }
+            if(node->sibling)
+            {
+                node->sibling->previous = node->previous;
+            }
+            node->sibling = nullptr;
+            node->previous = nullptr;
+        }
+
+        // Children are threaded in front of their parent through sibling links, so
+        // arbitrarily deep heaps are freed without recursion.
+        void destroy_subtree(node_type* node)
+        {
+            while(node)
+            {
+                if(node_type* child{node->child})
+                {
+                    node->child = child->sibling;
+                    child->sibling = node;
+                    node = child;
+                    continue;
+                }
+                node_type* next{node->sibling};
+                pool.destroy(node);
+                node = next;
+            }
+        }
+
+        node_type* root;
+        size_type count;
+        NodePool<node_type> pool;
+        key_compare compare;
+    };
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef PARALLEL_GRAPH_SEARCH_H
+#define PARALLEL_GRAPH_SEARCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "graph.h"
+#include "multi_queue.h"
+
+namespace algo
+{
+    // expanded counts pops whose distance was still current, stale counts pops that a
+    // shorter path had already superseded. A sequential Dijkstra has expanded == reached
+    // and stale == 0; anything above that is work wasted on relaxed pop order.
+    struct ParallelSearchWork
+    {
+        std::size_t reached;
+        std::size_t expanded;
+        std::size_t stale;
+    };
+
+    // Label-correcting Dijkstra over a MultiQueue: every thread pops a near-minimal
+    // (distance, vertex) entry, drops it if the vertex has improved since, and
+    // otherwise lowers neighbour distances with compare-and-swap. The search ends
+    // when no entry is queued or being expanded, which pending tracks.
+    template<typename Weight>
+    class ParallelGraphSearch
+    {
+    public:
+        using graph_type = CompressedGraph<Weight>;
+        using vertex_type = typename graph_type::vertex_type;
+        using weight_type = Weight;
+        using size_type = std::size_t;
+        using entry_type = std::pair<Weight, vertex_type>;
+
+        static constexpr weight_type unreachable{std::numeric_limits<weight_type>::max()};
+
+        ParallelGraphSearch(const graph_type& graph, size_type threadCount,
+                            size_type lanesPerThread = MultiQueue<entry_type>::lanesPerThread)
+            : graph{&graph}, threadCount{threadCount}
+            , spinRounds{threadCount <= std::thread::hardware_concurrency()? idleSpinRounds : 0}
+            , queue{std::max<size_type>(1, threadCount * lanesPerThread)}
+            , distances(graph.vertex_count()), pending{0}
+        {
+            if(threadCount == 0)
+            {
+                throw std::invalid_argument{"Error: a parallel search needs at least one thread."};
+            }
+        }
+
+        ParallelSearchWork dijkstra(vertex_type source)
+        {
+            if(source >= graph->vertex_count())
+            {
+                throw std::out_of_range{"Error: source is not a vertex."};
+            }
+            for(auto& distance : distances)
+            {
+                distance.store(unreachable, std::memory_order_relaxed);
+            }
+            distances[source].store(weight_type{}, std::memory_order_relaxed);
+            pending.store(1, std::memory_order_relaxed);
+            queue.push(entry_type{weight_type{}, source});
+
+            std::vector<ParallelSearchWork> work(threadCount, ParallelSearchWork{0, 0, 0});
+            {
+                std::vector<std::jthread> workers;
+                workers.reserve(threadCount);
+                for(size_type index{0}; index < threadCount; ++index)
+                {
+                    workers.emplace_back([this, &work, index]
+                    {
+                        run_worker(work[index]);
+                    });
+                }
+            }
+
+            ParallelSearchWork total{0, 0, 0};
+            for(const auto& part : work)
+            {
+                total.expanded += part.expanded;
+                total.stale += part.stale;
+            }
+            for(const auto& distance : distances)
+            {
+                total.reached += distance.load(std::memory_order_relaxed) != unreachable;
+            }
+            return total;
+        }
+
+        weight_type distance(vertex_type vertex) const noexcept
+        {
+            return distances[vertex].load(std::memory_order_relaxed);
+        }
+
+        size_type thread_count() const noexcept
+        {
+            return threadCount;
+        }
+    private:
+        void run_worker(ParallelSearchWork& work)
+        {
+            size_type idleRounds{0};
+            while(true)
+            {
+                auto entry{queue.try_pop()};
+                if(!entry)
+                {
+                    if(pending.load(std::memory_order_acquire) == 0)
+                    {
+                        return;
+                    }
+                    back_off(idleRounds++);
+                    continue;
+                }
+                idleRounds = 0;
+                const auto [distance, vertex]{*entry};
+                if(distances[vertex].load(std::memory_order_relaxed) < distance)
+                {
+                    ++work.stale;
+                }
+                else
+                {
+                    ++work.expanded;
+                    relax(vertex, distance);
+                }
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+        // An idle worker retries at once while the entries it waits for are probably
+        // being relaxed, unless the workers outnumber the cores and spinning would only
+        // delay the thread that holds them. Then it yields, and once the frontier has
+        // shrunk to a few vertices it sleeps in doubling steps of up to 64 microseconds,
+        // so it stops contending for lanes.
+        void back_off(size_type idleRounds) const
+        {
+            if(idleRounds < spinRounds)
+            {
+                return;
+            }
+            if(idleRounds < yieldRounds)
+            {
+                std::this_thread::yield();
+                return;
+            }
+            const size_type shift{std::min(idleRounds - yieldRounds, maxIdleSleepShift)};
+            std::this_thread::sleep_for(std::chrono::microseconds{std::int64_t{1} << shift});
+        }
+
+        void relax(vertex_type vertex, weight_type distance)
+        {
+            for(const auto& arc : graph->arcs_of(vertex))
+            {
+                weight_type candidate{distance + arc.weight};
+                weight_type current{distances[arc.target].load(std::memory_order_relaxed)};
+                while(candidate < current)
+                {
+                    if(distances[arc.target].compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+                    {
+                        pending.fetch_add(1, std::memory_order_relaxed);
+                        queue.push(entry_type{candidate, arc.target});
+                        break;
+                    }
+                }
+            }
+        }
+
+        static constexpr size_type idleSpinRounds{16};
+        static constexpr size_type yieldRounds{256};
+        static constexpr size_type maxIdleSleepShift{6};
+
+        const graph_type* graph;
+        size_type threadCount;
+        size_type spinRounds;
+        MultiQueue<entry_type> queue;
+        std::vector<std::atomic<weight_type>> distances;
+        std::atomic<size_type> pending;
+    };
+}
+
+#endif
@@ -0,0 +1,491 @@
+#ifndef PERSISTENT_RED_BLACK_TREE_H
+#define PERSISTENT_RED_BLACK_TREE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "red_black_tree.h"
+
+namespace algo
+{
+    template<typename Key,
+             typename Type>
+    struct PersistentRedBlackNode
+    {
+        template<typename... Args>
+        PersistentRedBlackNode(PersistentRedBlackNode* left,
+                               PersistentRedBlackNode* right,
+                               RedBlackColor color,
+                               Key key, Args&&... args)
+            : left{left}, right{right}
+            , references{1}, color{color}
+            , key{std::move(key)}, data{std::forward<Args>(args)...}
+        {
+        }
+
+        PersistentRedBlackNode* left;
+        PersistentRedBlackNode* right;
+        std::atomic<std::uint32_t> references;
+        RedBlackColor color;
+        const Key key;
+        Type data;
+    };
+
+    // Nodes carry no parent pointer and are shared between versions through a
+    // reference count. A node is mutated in place only while exactly one version
+    // references it; otherwise it is copied first, so an update copies at most the
+    // O(log n) nodes it touches and copying a tree is O(1).
+    template<typename Key,
+             typename Type,
+             typename Compare = std::less<Key>>
+    class PersistentRedBlackTree
+    {
+    public:
+        using key_type = Key;
+        using value_type = Type;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using difference_type = std::ptrdiff_t;
+        using node_type = PersistentRedBlackNode<Key, Type>;
+        using allocator_type = std::allocator<node_type>;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using const_iterator = const node_type*;
+
+        PersistentRedBlackTree()
+            : root{nullptr}, alloc{}
+            , compare{}
+        {
+        }
+
+        PersistentRedBlackTree(const PersistentRedBlackTree& that)
+            : root{that.root}, alloc{that.alloc}
+            , compare{that.compare}
+        {
+            retain(root);
+        }
+
+        PersistentRedBlackTree& operator=(const PersistentRedBlackTree& that)
+        {
+            PersistentRedBlackTree{that}.swap(*this);
+            return *this;
+        }
+
+        PersistentRedBlackTree(PersistentRedBlackTree&& that) noexcept
+            : root{that.root}, alloc{std::move(that.alloc)}
+            , compare{std::move(that.compare)}
+        {
+            that.root = nullptr;
+        }
+
+        PersistentRedBlackTree& operator=(PersistentRedBlackTree&& that) noexcept
+        {
+            PersistentRedBlackTree{std::move(that)}.swap(*this);
+            return *this;
+        }
+
+        ~PersistentRedBlackTree()
+        {
+            clear();
+        }
+
+        PersistentRedBlackTree snapshot() const
+        {
+            return PersistentRedBlackTree{*this};
+        }
+
+        template<typename... Args>
+        const_iterator emplace(const key_type& key, Args&&... args)
+        {
+            if(const_iterator found{find(key)})
+            {
+                return found;
+            }
+            node_type* inserted{nullptr};
+            root = insert_subtree(root, key, &inserted, std::forward<Args>(args)...);
+            root->color = RedBlackColor::black;
+            return inserted;
+        }
+
+        const_iterator insert(const key_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        void remove(const key_type& key)
+        {
+            if(find(key) == nullptr)
+            {
+                return;
+            }
+            bool shortened{false};
+            root = remove_subtree(root, key, &shortened);
+            if(root)
+            {
+                root = own(root);
+                root->color = RedBlackColor::black;
+            }
+        }
+
+        reference operator[](const key_type& key)
+        {
+            emplace(key, value_type{});
+            node_type** position{&root};
+            while(true)
+            {
+                *position = own(*position);
+                if(compare(key, (*position)->key))
+                {
+                    position = &(*position)->left;
+                }
+                else if(compare((*position)->key, key))
+                {
+                    position = &(*position)->right;
+                }
+                else
+                {
+                    return (*position)->data;
+                }
+            }
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            const node_type* position{root};
+            while(position)
+            {
+                if(compare(key, position->key))
+                {
+                    position = position->left;
+                }
+                else if(compare(position->key, key))
+                {
+                    position = position->right;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            return position;
+        }
+
+        template<typename Function>
+        void for_each(Function function) const
+        {
+            for_each_subtree(root, function);
+        }
+
+        bool empty() const noexcept
+        {
+            return root == nullptr;
+        }
+
+        void swap(PersistentRedBlackTree& that) noexcept
+        {
+            std::swap(this->root, that.root);
+            std::swap(this->alloc, that.alloc);
+            std::swap(this->compare, that.compare);
+        }
+
+        void clear()
+        {
+            release(root);
+            root = nullptr;
+        }
+    private:
+        static void retain(node_type* node) noexcept
+        {
+            if(node)
+            {
+                node->references.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void release(node_type* node)
+        {
+            while(node
+                  && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                release(node->right);
+                node_type* left{node->left};
+                std::allocator_traits<allocator_type>::destroy(alloc, node);
+                std::allocator_traits<allocator_type>::deallocate(alloc, node, 1);
+                node = left;
+            }
+        }
+
+        template<typename... Args>
+        node_type* make_node(node_type* left, node_type* right, RedBlackColor color, const key_type& key, Args&&... args)
+        {
+            node_type* fresh{std::allocator_traits<allocator_type>::allocate(alloc, 1)};
+            std::allocator_traits<allocator_type>::construct(alloc, fresh, left, right, color, key, std::forward<Args>(args)...);
+            return fresh;
+        }
+
+        node_type* own(node_type* node)
+        {
+            if(node->references.load(std::memory_order_acquire) == 1)
+            {
+                return node;
+            }
+            node_type* copy{make_node(node->left, node->right, node->color, node->key, node->data)};
+            retain(copy->left);
+            retain(copy->right);
+            release(node);
+            return copy;
+        }
+
+        void drop_detached(node_type* node)
+        {
+            node->left = nullptr;
+            node->right = nullptr;
+            release(node);
+        }
+
+        bool is_node_red(const node_type* node) const noexcept
+        {
+            return node && node->color == RedBlackColor::red;
+        }
+
+        template<typename... Args>
+        node_type* insert_subtree(node_type* node, const key_type& key, node_type** inserted, Args&&... args)
+        {
+            if(node == nullptr)
+            {
+                *inserted = make_node(nullptr, nullptr, RedBlackColor::red, key, std::forward<Args>(args)...);
+                return *inserted;
+            }
+            node = own(node);
+            if(compare(key, node->key))
+            {
+                node->left = insert_subtree(node->left, key, inserted, std::forward<Args>(args)...);
+            }
+            else
+            {
+                node->right = insert_subtree(node->right, key, inserted, std::forward<Args>(args)...);
+            }
+            return insert_balance(node);
+        }
+
+        node_type* insert_balance(node_type* node) noexcept
+        {
+            if(is_node_red(node))
+            {
+                return node;
+            }
+            node_type* top{nullptr};
+            node_type* lower{nullptr};
+            node_type* upper{nullptr};
+            if(is_node_red(node->left) && is_node_red(node->left->left))
+            {
+                top = node->left;
+                lower = top->left;
+                upper = node;
+                upper->left = top->right;
+            }
+            else if(is_node_red(node->left) && is_node_red(node->left->right))
+            {
+                lower = node->left;
+                top = lower->right;
+                upper = node;
+                lower->right = top->left;
+                upper->left = top->right;
+            }
+            else if(is_node_red(node->right) && is_node_red(node->right->left))
+            {
+                lower = node;
+                upper = node->right;
+                top = upper->left;
+                lower->right = top->left;
+                upper->left = top->right;
+            }
+            else if(is_node_red(node->right) && is_node_red(node->right->right))
+            {
+                top = node->right;
+                lower = node;
+                upper = top->right;
+                lower->right = top->left;
+            }
+            else
+            {
+                return node;
+            }
+            top->left = lower;
+            top->right = upper;
+            top->color = RedBlackColor::red;
+            lower->color = RedBlackColor::black;
+            upper->color = RedBlackColor::black;
+            return top;
+        }
+
+        node_type* remove_subtree(node_type* node, const key_type& key, bool* shortened)
+        {
+            node = own(node);
+            if(compare(key, node->key))
+            {
+                node->left = remove_subtree(node->left, key, shortened);
+                return *shortened? fix_left_shortened(node, shortened) : node;
+            }
+            if(compare(node->key, key))
+            {
+                node->right = remove_subtree(node->right, key, shortened);
+                return *shortened? fix_right_shortened(node, shortened) : node;
+            }
+            if(node->left == nullptr
+               || node->right == nullptr)
+            {
+                return unlink_single(node, shortened);
+            }
+            node_type* successor{nullptr};
+            node_type* right{remove_minimum(node->right, &successor, shortened)};
+            successor->left = node->left;
+            successor->right = right;
+            successor->color = node->color;
+            drop_detached(node);
+            return *shortened? fix_right_shortened(successor, shortened) : successor;
+        }
+
+        node_type* remove_minimum(node_type* node, node_type** minimum, bool* shortened)
+        {
+            node = own(node);
+            if(node->left == nullptr)
+            {
+                *minimum = node;
+                return unlink_single(node, shortened, false);
+            }
+            node->left = remove_minimum(node->left, minimum, shortened);
+            return *shortened? fix_left_shortened(node, shortened) : node;
+        }
+
+        node_type* unlink_single(node_type* node, bool* shortened, bool destroy = true)
+        {
+            node_type* child{node->left? node->left : node->right};
+            *shortened = false;
+            if(!is_node_red(node))
+            {
+                if(is_node_red(child))
+                {
+                    child = own(child);
+                    child->color = RedBlackColor::black;
+                }
+                else
+                {
+                    *shortened = true;
+                }
+            }
+            node->left = nullptr;
+            node->right = nullptr;
+            if(destroy)
+            {
+                release(node);
+            }
+            return child;
+        }
+
+        node_type* fix_left_shortened(node_type* node, bool* shortened)
+        {
+            node->right = own(node->right);
+            node_type* sibling{node->right};
+            if(is_node_red(sibling))
+            {
+                node->right = sibling->left;
+                sibling->left = node;
+                sibling->color = RedBlackColor::black;
+                node->color = RedBlackColor::red;
+                sibling->left = fix_left_shortened(node, shortened);
+                *shortened = false;
+                return sibling;
+            }
+            if(!is_node_red(sibling->left)
+               && !is_node_red(sibling->right))
+            {
+                sibling->color = RedBlackColor::red;
+                *shortened = !is_node_red(node);
+                node->color = RedBlackColor::black;
+                return node;
+            }
+            if(!is_node_red(sibling->right))
+            {
+                node_type* inner{own(sibling->left)};
+                sibling->left = inner->right;
+                inner->right = sibling;
+                inner->color = RedBlackColor::black;
+                sibling->color = RedBlackColor::red;
+                node->right = inner;
+                sibling = inner;
+            }
+            sibling->right = own(sibling->right);
+            sibling->right->color = RedBlackColor::black;
+            sibling->color = node->color;
+            node->color = RedBlackColor::black;
+            node->right = sibling->left;
+            sibling->left = node;
+            *shortened = false;
+            return sibling;
+        }
+
+        node_type* fix_right_shortened(node_type* node, bool* shortened)
+        {
+            node->left = own(node->left);
+            node_type* sibling{node->left};
+            if(is_node_red(sibling))
+            {
+                node->left = sibling->right;
+                sibling->right = node;
+                sibling->color = RedBlackColor::black;
+                node->color = RedBlackColor::red;
+                sibling->right = fix_right_shortened(node, shortened);
+                *shortened = false;
+                return sibling;
+            }
+            if(!is_node_red(sibling->left)
+               && !is_node_red(sibling->right))
+            {
+                sibling->color = RedBlackColor::red;
+                *shortened = !is_node_red(node);
+                node->color = RedBlackColor::black;
+                return node;
+            }
+            if(!is_node_red(sibling->left))
+            {
+                node_type* inner{own(sibling->right)};
+                sibling->right = inner->left;
+                inner->left = sibling;
+                inner->color = RedBlackColor::black;
+                sibling->color = RedBlackColor::red;
+                node->left = inner;
+                sibling = inner;
+            }
+            sibling->left = own(sibling->left);
+            sibling->left->color = RedBlackColor::black;
+            sibling->color = node->color;
+            node->color = RedBlackColor::black;
+            node->left = sibling->right;
+            sibling->right = node;
+            *shortened = false;
+            return sibling;
+        }
+
+        template<typename Function>
+        static void for_each_subtree(const node_type* node, Function& function)
+        {
+            while(node)
+            {
+                for_each_subtree(node->left, function);
+                function(node->key, node->data);
+                node = node->right;
+            }
+        }
+
+        node_type* root;
+        allocator_type alloc;
+        key_compare compare;
+    };
+}
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "addressable_heap.h"
+
+namespace algo
+{
+    // Unsigned keys are their own priority; pair-like keys are prioritised by their
+    // first member, so (distance, vertex) entries work without a custom projection.
+    template<typename Key>
+    struct RadixPriority
+    {
+        auto operator()(const Key& key) const noexcept
+        {
+            if constexpr(std::unsigned_integral<Key>)
+            {
+                return key;
+            }
+            else
+            {
+                return key.first;
+            }
+        }
+    };
+
+    // Monotone heap: every key pushed or decreased must not be below the last popped
+    // priority. Buckets are split by the highest bit in which a priority differs from
+    // that last priority, so each entry is redistributed at most once per bit.
+    template<typename Key,
+             typename Priority = RadixPriority<Key>>
+    class radix_heap
+    {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using size_type = std::size_t;
+        using priority_type = std::remove_cvref_t<std::invoke_result_t<const Priority&, const Key&>>;
+        using handle = size_type;
+        using const_reference = const key_type&;
+
+        static_assert(std::unsigned_integral<priority_type>, "Radix heap priorities must be unsigned integers.");
+
+        static constexpr size_type bucketCount{std::numeric_limits<priority_type>::digits + 1};
+
+        radix_heap()
+            : buckets{}, positions{}
+            , freeSlots{}, last{0}
+            , count{0}, priority{}
+        {
+        }
+
+        handle push(const key_type& key)
+        {
+            return emplace(key);
+        }
+
+        handle push(key_type&& key)
+        {
+            return emplace(std::move(key));
+        }
+
+        template<typename... Args>
+        handle emplace(Args&&... args)
+        {
+            Entry entry{key_type(std::forward<Args>(args)...), 0};
+            check_monotone(entry.key);
+            handle slot{acquire_slot()};
+            entry.slot = slot;
+            insert_entry(std::move(entry));
+            ++count;
+            return slot;
+        }
+
+        // Without a pending redistribution this is O(1); otherwise it scans one bucket.
+        const_reference top() const
+        {
+            if(count == 0)
+            {
+                throw std::out_of_range{"Error: top of an empty heap."};
+            }
+            if(!buckets[0].empty())
+            {
+                return buckets[0].back().key;
+            }
+            return lookup_minimum().key;
+        }
+
+        void pop()
+        {
+            if(count == 0)
+            {
+                throw std::out_of_range{"Error: pop of an empty heap."};
+            }
+            if(buckets[0].empty())
+            {
+                handle minimum{lookup_minimum().slot};
+                redistribute();
+                remove_entry(positions[minimum]);
+                release_slot(minimum);
+            }
+            else
+            {
+                release_slot(buckets[0].back().slot);
+                buckets[0].pop_back();
+            }
+            --count;
+        }
+
+        void decrease_key(handle slot, const key_type& key)
+        {
+            Location location{positions[slot]};
+            if(priority(buckets[location.bucket][location.index].key) < priority(key))
+            {
+                throw std::invalid_argument{"Error: new key is worse than the current one."};
+            }
+            check_monotone(key);
+            Entry entry{remove_entry(location)};
+            entry.key = key;
+            insert_entry(std::move(entry));
+        }
+
+        void erase(handle slot)
+        {
+            remove_entry(positions[slot]);
+            release_slot(slot);
+            --count;
+        }
+
+        size_type size() const noexcept
+        {
+            return count;
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        void clear()
+        {
+            for(auto& bucket : buckets)
+            {
+                bucket.clear();
+            }
+            positions.clear();
+            freeSlots.clear();
+            last = 0;
+            count = 0;
+        }
+    private:
+        struct Entry
+        {
+            key_type key;
+            handle slot;
+        };
+
+        struct Location
+        {
+            std::uint32_t bucket;
+            std::uint32_t index;
+        };
+
+        size_type bucket_of(priority_type value) const noexcept
+        {
+            return static_cast<size_type>(std::bit_width(static_cast<priority_type>(value ^ last)));
+        }
+
+        void check_monotone(const key_type& key) const
+        {
+            if(priority(key) < last)
+            {
+                throw std::invalid_argument{"Error: key is below the last popped priority."};
+            }
+        }
+
+        handle acquire_slot()
+        {
+            if(freeSlots.empty())
+            {
+                positions.push_back(Location{});
+                return positions.size() - 1;
+            }
+            handle slot{freeSlots.back()};
+            freeSlots.pop_back();
+            return slot;
+        }
+
+        void release_slot(handle slot)
+        {
+            freeSlots.push_back(slot);
+        }
+
+        void insert_entry(Entry&& entry)
+        {
+            size_type bucket{bucket_of(priority(entry.key))};
+            positions[entry.slot] = Location{static_cast<std::uint32_t>(bucket), static_cast<std::uint32_t>(buckets[bucket].size())};
+            buckets[bucket].push_back(std::move(entry));
+        }
+
+        Entry remove_entry(Location location)
+        {
+            std::vector<Entry>& bucket{buckets[location.bucket]};
+            Entry removed{std::move(bucket[location.index])};
+            if(location.index + 1 != bucket.size())
+            {
+                bucket[location.index] = std::move(bucket.back());
+                positions[bucket[location.index].slot] = location;
+            }
+            bucket.pop_back();
+            return removed;
+        }
+
+        // Scans the first non-empty bucket, which holds the minimum once bucket 0 is empty.
+        const Entry& lookup_minimum() const noexcept
+        {
+            size_type index{1};
+            while(buckets[index].empty())
+            {
+                ++index;
+            }
+            const Entry* best{&buckets[index].front()};
+            for(const Entry& entry : buckets[index])
+            {
+                if(priority(entry.key) < priority(best->key))
+                {
+                    best = &entry;
+                }
+            }
+            return *best;
+        }
+
+        void redistribute()
+        {
+            size_type index{1};
+            while(buckets[index].empty())
+            {
+                ++index;
+            }
+            last = priority(lookup_minimum().key);
+            std::vector<Entry> moving{std::move(buckets[index])};
+            buckets[index].clear();
+            for(Entry& entry : moving)
+            {
+                insert_entry(std::move(entry));
+            }
+            moving.clear();
+            buckets[index].swap(moving);
+        }
+
+        std::array<std::vector<Entry>, bucketCount> buckets;
+        std::vector<Location> positions;
+        std::vector<handle> freeSlots;
+        priority_type last;
+        size_type count;
+        Priority priority;
+    };
+}
+
+#endif
@@ -6,13 +6,38 @@
 #include <print>
 #include <queue>
 //remove
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstdint>
+#include <future>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <functional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
 
 namespace algo
 {
+    inline void prefetch_address(const void* address) noexcept
+    {
+#if defined(_MSC_VER)
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+        __builtin_prefetch(address);
+#endif
+    }
+
     enum class RedBlackColor : std::uint8_t
     {
         red = 0,
@@ -31,108 +56,1321 @@ namespace algo
         {
         }
 
-        template<typename... Args>
-        RedBlackNode(RedBlackNode* parent, 
-                     RedBlackNode* left, 
-                     RedBlackNode* right, 
-                     RedBlackColor color, 
-                     Key key, Args&&... args)
-            : parent{parent}, left{left}
-            , right{right}, color{color}
-            , key{std::move(key)}, data{std::forward<Args>(args)...}
+        template<typename... Args>
+        RedBlackNode(RedBlackNode* parent, 
+                     RedBlackNode* left, 
+                     RedBlackNode* right, 
+                     RedBlackColor color, 
+                     Key key, Args&&... args)
+            : parent{parent}, left{left}
+            , right{right}, color{color}
+            , key{std::move(key)}, data{std::forward<Args>(args)...}
+        {
+        }
+
+        RedBlackNode* get_parent() const noexcept
+        {
+            return parent;
+        }
+
+        void set_parent(RedBlackNode* fresh) noexcept
+        {
+            parent = fresh;
+        }
+
+        RedBlackColor get_color() const noexcept
+        {
+            return color;
+        }
+
+        void set_color(RedBlackColor fresh) noexcept
+        {
+            color = fresh;
+        }
+
+        RedBlackNode* parent;
+        RedBlackNode* left;
+        RedBlackNode* right;
+        RedBlackColor color;
+        const Key key;
+        Type data;
+    };
+
+    // Same interface as RedBlackNode, but the color lives in the low bit of the
+    // parent pointer, which is always zero because nodes are pointer aligned.
+    template<typename Key, 
+             typename Type>
+    struct PackedRedBlackNode
+    {
+        template<typename... Args>
+        PackedRedBlackNode(PackedRedBlackNode* parent, 
+                           PackedRedBlackNode* left, 
+                           PackedRedBlackNode* right, 
+                           RedBlackColor color, 
+                           Key key, Args&&... args)
+            : left{left}, right{right}
+            , parentAndColor{reinterpret_cast<std::uintptr_t>(parent) | static_cast<std::uintptr_t>(color)}
+            , key{std::move(key)}, data{std::forward<Args>(args)...}
+        {
+        }
+
+        PackedRedBlackNode* get_parent() const noexcept
+        {
+            return reinterpret_cast<PackedRedBlackNode*>(parentAndColor & ~colorMask);
+        }
+
+        void set_parent(PackedRedBlackNode* fresh) noexcept
+        {
+            parentAndColor = reinterpret_cast<std::uintptr_t>(fresh) | (parentAndColor & colorMask);
+        }
+
+        RedBlackColor get_color() const noexcept
+        {
+            return static_cast<RedBlackColor>(parentAndColor & colorMask);
+        }
+
+        void set_color(RedBlackColor fresh) noexcept
+        {
+            parentAndColor = (parentAndColor & ~colorMask) | static_cast<std::uintptr_t>(fresh);
+        }
+
+        static constexpr std::uintptr_t colorMask{1};
+
+        PackedRedBlackNode* left;
+        PackedRedBlackNode* right;
+        std::uintptr_t parentAndColor;
+        const Key key;
+        Type data;
+    };
+
+    // Counted per tree when ALGO_RED_BLACK_TREE_STATS is defined. The macro adds a
+    // member to RedBlackTree and its node handles, so every translation unit of a
+    // program must agree on it; mixing them violates the one definition rule.
+    enum class RedBlackEvent : std::uint8_t
+    {
+        comparison = 0,
+        rotation,
+        insert_fixup_case1,
+        insert_fixup_case2,
+        insert_fixup_case3,
+        delete_fixup_case1,
+        delete_fixup_case2,
+        delete_fixup_case3,
+        delete_fixup_case4,
+        allocation,
+        deallocation,
+        max_red_black_event,
+    };
+
+    struct RedBlackShape
+    {
+        std::size_t size{0};
+        std::size_t height{0};
+        std::size_t blackHeight{0};
+        std::vector<std::size_t> depthHistogram{};
+    };
+
+    // The parallel set operations free nodes from several threads at once, so they only
+    // fork when the node allocator is listed here. Memory resources such as
+    // monotonic_buffer_resource or unsynchronized_pool_resource are not, and a caller
+    // cannot lock around threads the tree starts itself. Specialize this for a custom
+    // allocator whose allocate and deallocate may run concurrently.
+    template<typename Allocator>
+    struct ThreadSafeAllocator : std::false_type
+    {
+    };
+
+    template<typename Type>
+    struct ThreadSafeAllocator<std::allocator<Type>> : std::true_type
+    {
+    };
+
+    template<typename Compare>
+    concept TransparentComparator = requires
+    {
+        typename Compare::is_transparent;
+    };
+
+    template<typename Node>
+    concept AugmentedRedBlackNode = requires(Node& node)
+    {
+        node.update_augment();
+    };
+
+    template<typename Key, 
+             typename Type, 
+             typename Compare>
+    class ConcurrentRedBlackTree;
+
+    template<typename Point, 
+             typename Type>
+    class IntervalTree;
+
+    template<typename Key, 
+             typename Type, 
+             typename Compare = std::less<Key>,
+             typename Node = RedBlackNode<Key, Type>,
+             typename Allocator = std::allocator<Node>>
+    class RedBlackTree
+    {
+        friend class ConcurrentRedBlackTree<Key, Type, Compare>;
+        template<typename, typename>
+        friend class IntervalTree;
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+        // Shared with node handles, which may free an extracted node after the tree is gone.
+        using EventCounters = std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(RedBlackEvent::max_red_black_event)>;
+#endif
+    public:
+        using key_type = Key;
+        using value_type = Type;
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using difference_type = std::ptrdiff_t;
+        using node_type = Node;
+        using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+        using reference = value_type&;
+        using const_reference = const value_type&; 
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = node_type*;
+
+        // Owns a node unlinked by extract() until it is linked again by insert().
+        class NodeHandle
+        {
+        public:
+            NodeHandle() noexcept
+                : node{nullptr}, alloc{}
+            {
+            }
+
+            NodeHandle(NodeHandle&& that) noexcept
+                : node{that.node}, alloc{std::move(that.alloc)}
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+                , events{std::move(that.events)}
+#endif
+            {
+                that.node = nullptr;
+                that.alloc.reset();
+            }
+
+            // The allocator is re-emplaced rather than assigned, since allocators such as
+            // std::pmr::polymorphic_allocator cannot be assigned.
+            NodeHandle& operator=(NodeHandle&& that) noexcept
+            {
+                if(this != &that)
+                {
+                    release();
+                    node = that.node;
+                    alloc.reset();
+                    if(that.alloc)
+                    {
+                        alloc.emplace(std::move(*that.alloc));
+                    }
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+                    events = std::move(that.events);
+#endif
+                    that.node = nullptr;
+                    that.alloc.reset();
+                }
+                return *this;
+            }
+
+            ~NodeHandle()
+            {
+                release();
+            }
+
+            bool empty() const noexcept
+            {
+                return node == nullptr;
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return node != nullptr;
+            }
+
+            const key_type& key() const noexcept
+            {
+                return node->key;
+            }
+
+            value_type& mapped() const noexcept
+            {
+                return node->data;
+            }
+
+            void swap(NodeHandle& that) noexcept
+            {
+                NodeHandle temporary{std::move(that)};
+                that = std::move(*this);
+                *this = std::move(temporary);
+            }
+        private:
+            friend class RedBlackTree;
+
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+            NodeHandle(node_type* node, const allocator_type& alloc, std::shared_ptr<EventCounters> events) noexcept
+                : node{node}, alloc{alloc}, events{std::move(events)}
+            {
+            }
+#else
+            NodeHandle(node_type* node, const allocator_type& alloc) noexcept
+                : node{node}, alloc{alloc}
+            {
+            }
+#endif
+
+            // A node dropped without being reinserted is freed here, and counted against
+            // the tree it was extracted from.
+            void release() noexcept
+            {
+                if(node)
+                {
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+                    (*events)[static_cast<std::size_t>(RedBlackEvent::deallocation)].fetch_add(1, std::memory_order_relaxed);
+#endif
+                    std::allocator_traits<allocator_type>::destroy(*alloc, node);
+                    std::allocator_traits<allocator_type>::deallocate(*alloc, node, 1);
+                    node = nullptr;
+                }
+            }
+
+            node_type* node;
+            std::optional<allocator_type> alloc;
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+            std::shared_ptr<EventCounters> events;
+#endif
+        };
+
+        using node_handle = NodeHandle;
+
+        RedBlackTree() 
+            : root{nullptr}, rightmost{nullptr}
+            , alloc{}, compare{}
+        {
+        }
+
+        explicit RedBlackTree(const allocator_type& alloc)
+            : root{nullptr}, rightmost{nullptr}
+            , alloc{alloc}, compare{}
+        {
+        }
+
+        explicit RedBlackTree(const key_compare& compare, const allocator_type& alloc = allocator_type{})
+            : root{nullptr}, rightmost{nullptr}
+            , alloc{alloc}, compare{compare}
+        {
+        }
+        
+        RedBlackTree(const RedBlackTree& that)
+            : RedBlackTree{that, alloc_traits::select_on_container_copy_construction(that.alloc)}
+        {
+        }
+
+        RedBlackTree(const RedBlackTree& that, const allocator_type& alloc)
+            : root{nullptr}, rightmost{nullptr}
+            , alloc{alloc}, compare{that.compare}
+        {
+            reset_root(Subtree{copy_subtree(that.root, nullptr), 0});
+        }
+
+        RedBlackTree& operator=(const RedBlackTree& that)
+        {
+            if(this != &that)
+            {
+                RedBlackTree copy{that, alloc_traits::propagate_on_container_copy_assignment::value? that.alloc : alloc};
+                adopt<typename alloc_traits::propagate_on_container_copy_assignment>(copy);
+            }
+            return *this;
+        }
+
+        RedBlackTree(RedBlackTree&& that) noexcept
+            : root{that.root}, rightmost{that.rightmost}
+            , alloc{std::move(that.alloc)}, compare{std::move(that.compare)}
+        {
+            that.root = nullptr;
+            that.rightmost = nullptr;
+        }
+
+        // Steals the nodes when alloc can free them, otherwise copies them over.
+        RedBlackTree(RedBlackTree&& that, const allocator_type& alloc)
+            : root{nullptr}, rightmost{nullptr}
+            , alloc{alloc}, compare{that.compare}
+        {
+            if(this->alloc == that.alloc)
+            {
+                std::swap(root, that.root);
+                std::swap(rightmost, that.rightmost);
+            }
+            else
+            {
+                reset_root(Subtree{copy_subtree(that.root, nullptr), 0});
+                that.clear();
+            }
+        }
+
+        RedBlackTree& operator=(RedBlackTree&& that) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                                              || alloc_traits::is_always_equal::value)
+        {
+            if(this != &that)
+            {
+                RedBlackTree moved{std::move(that), alloc_traits::propagate_on_container_move_assignment::value? that.alloc : alloc};
+                adopt<typename alloc_traits::propagate_on_container_move_assignment>(moved);
+            }
+            return *this;
+        }
+
+        ~RedBlackTree() 
+        {
+            clear();
+        }
+        
+        template<typename... Args>
+        iterator emplace(const key_type& key, Args&&... args)
+        {
+            node_type* parent{nullptr};
+            node_type** position{lookup_position(key, &parent, &root)};
+            if(*position != nullptr)
+            {
+                return iterator{*position};
+            }
+            return iterator{construct_at_position(position, parent, key, std::forward<Args>(args)...)};
+        }
+
+        // The key and the value are only constructed once the key is known to be absent.
+        template<typename... Args>
+        iterator try_emplace(const key_type& key, Args&&... args)
+        {
+            return try_emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator try_emplace(key_type&& key, Args&&... args)
+        {
+            return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template<typename Lookup, typename... Args>
+            requires TransparentComparator<key_compare> 
+                     && std::is_constructible_v<key_type, Lookup>
+        iterator try_emplace(Lookup&& key, Args&&... args)
+        {
+            return try_emplace_key(std::forward<Lookup>(key), std::forward<Args>(args)...);
+        }
+
+        // A null hint stands for the end of the tree, so appending increasing keys with
+        // emplace_hint(nullptr, ...) skips the search and costs amortized O(1).
+        template<typename... Args>
+        iterator emplace_hint(iterator hint, const key_type& key, Args&&... args)
+        {
+            node_type* parent{nullptr};
+            node_type** position{hint_position(hint, key, &parent)};
+            if(*position != nullptr)
+            {
+                return iterator{*position};
+            }
+            return iterator{construct_at_position(position, parent, key, std::forward<Args>(args)...)};
+        }
+
+        iterator insert(const key_type& key, const value_type& value)
+        {
+            return emplace(key, value);
+        }
+
+        // Links the handle's node without reallocating it. If the key is already present
+        // the handle keeps its node and the existing entry is returned.
+        iterator insert(node_handle&& handle)
+        {
+            if(handle.empty())
+            {
+                return nullptr;
+            }
+            check_same_allocator(*handle.alloc);
+            node_type* parent{nullptr};
+            node_type** position{lookup_position(handle.key(), &parent, &root)};
+            if(*position != nullptr)
+            {
+                return iterator{*position};
+            }
+            node_type* node{handle.node};
+            handle.node = nullptr;
+            node->set_parent(parent);
+            node->left = nullptr;
+            node->right = nullptr;
+            node->set_color(RedBlackColor::red);
+            update_augment(node);
+            *position = node;
+            insert_rebalance(node);
+            return iterator{node};
+        }
+
+        node_handle extract(const key_type& key)
+        {
+            return extract_node(find_node(key));
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        node_handle extract(const Lookup& key)
+        {
+            return extract_node(find_node(key));
+        }
+
+        // Moves every node whose key is absent here out of that, without reallocating.
+        void merge(RedBlackTree& that)
+        {
+            check_same_allocator(that.alloc);
+            std::vector<node_type*> nodes;
+            that.for_each_node_subtree(that.root, nodes);
+            for(node_type* node : nodes)
+            {
+                node_type* parent{nullptr};
+                node_type** position{hint_position(nullptr, node->key, &parent)};
+                if(*position != nullptr)
+                {
+                    continue;
+                }
+                that.delete_condition(node);
+                node->set_parent(parent);
+                node->left = nullptr;
+                node->right = nullptr;
+                node->set_color(RedBlackColor::red);
+                update_augment(node);
+                *position = node;
+                insert_rebalance(node);
+            }
+        }
+
+        void merge(RedBlackTree&& that)
+        {
+            merge(that);
+        }
+        
+        void remove(const key_type& key)
+        {
+            remove_node(find_node(key));
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        void remove(const Lookup& key)
+        {
+            remove_node(find_node(key));
+        }
+
+        reference operator[](const key_type& key)
+        {
+            return try_emplace(key)->data;
+        }
+
+        reference operator[](key_type&& key)
+        {
+            return try_emplace(std::move(key))->data;
+        }
+
+        template<typename Function>
+        void for_each(Function function) const
+        {
+            for_each_subtree(root, function);
+        }
+
+        iterator find(const key_type& key) const
+        {
+            return iterator{find_node(key)};
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        iterator find(const Lookup& key) const
+        {
+            return iterator{find_node(key)};
+        }
+
+        bool contains(const key_type& key) const
+        {
+            return find_node(key) != nullptr;
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        bool contains(const Lookup& key) const
+        {
+            return find_node(key) != nullptr;
+        }
+
+        iterator lower_bound(const key_type& key) const
+        {
+            return iterator{lower_bound_node(key)};
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        iterator lower_bound(const Lookup& key) const
+        {
+            return iterator{lower_bound_node(key)};
+        }
+
+        iterator upper_bound(const key_type& key) const
+        {
+            return iterator{upper_bound_node(key)};
+        }
+
+        template<typename Lookup>
+            requires TransparentComparator<key_compare>
+        iterator upper_bound(const Lookup& key) const
+        {
+            return iterator{upper_bound_node(key)};
+        }
+
+        // Keeps batchWidth walks in flight and advances them one level at a time, so the
+        // cache misses of independent walks overlap instead of being paid one by one.
+        void find_batch(std::span<const key_type> keys, std::span<iterator> out) const
+        {
+            if(out.size() < keys.size())
+            {
+                throw std::length_error{"Error: output span is smaller than key span."};
+            }
+            std::array<BatchWalk, batchWidth> walks{};
+            size_type active{0};
+            size_type next{0};
+            for(; active < batchWidth && next < keys.size(); ++active, ++next)
+            {
+                walks[active] = BatchWalk{root, next};
+            }
+            prefetch_address(root);
+            while(active > 0)
+            {
+                for(size_type slot{0}; slot < active;)
+                {
+                    BatchWalk& walk{walks[slot]};
+                    node_type* node{walk.node};
+                    const key_type& key{keys[walk.index]};
+                    if(node
+                       && key_less(key, node->key))
+                    {
+                        walk.node = node->left;
+                    }
+                    else if(node
+                            && key_less(node->key, key))
+                    {
+                        walk.node = node->right;
+                    }
+                    else
+                    {
+                        out[walk.index] = iterator{node};
+                        if(next == keys.size())
+                        {
+                            walk = walks[--active];
+                            continue;
+                        }
+                        walk = BatchWalk{root, next++};
+                    }
+                    prefetch_address(walk.node);
+                    ++slot;
+                }
+            }
+        }
+
+        bool empty() const noexcept
+        {
+            return root == nullptr;
+        }
+
+        void join(const key_type& key, const value_type& value, RedBlackTree&& upper)
+        {
+            check_same_allocator(upper.alloc);
+            count_event(RedBlackEvent::allocation);
+            node_type* middle{std::allocator_traits<allocator_type>::allocate(alloc, 1)};
+            std::allocator_traits<allocator_type>::construct(alloc, middle, nullptr, nullptr, nullptr, 
+                                                             RedBlackColor::red, key, value);
+            reset_root(join_subtree(whole_tree(), middle, upper.whole_tree()));
+            upper.reset_root(Subtree{});
+        }
+
+        void join2(RedBlackTree&& upper)
+        {
+            check_same_allocator(upper.alloc);
+            reset_root(join2_subtree(whole_tree(), upper.whole_tree()));
+            upper.reset_root(Subtree{});
+        }
+
+        RedBlackTree split(const key_type& key)
+        {
+            auto [lower, found, upper]{split_subtree(whole_tree(), key)};
+            if(found)
+            {
+                upper = join_subtree(Subtree{}, found, upper);
+            }
+            reset_root(lower);
+            RedBlackTree result{compare, alloc};
+            result.reset_root(upper);
+            return result;
+        }
+
+        // The set operations consume that. With a ThreadSafeAllocator, large inputs are
+        // split across worker threads, which then compare keys and free nodes
+        // concurrently, so the comparator must be safe to call from several threads at
+        // once. Every other allocator gets the same recursion on the calling thread.
+        void set_union(RedBlackTree&& that)
+        {
+            check_same_allocator(that.alloc);
+            reset_root(union_subtree(whole_tree(), that.whole_tree(), 0));
+            that.reset_root(Subtree{});
+        }
+
+        void set_intersection(RedBlackTree&& that)
+        {
+            check_same_allocator(that.alloc);
+            reset_root(intersection_subtree(whole_tree(), that.whole_tree(), 0));
+            that.reset_root(Subtree{});
+        }
+
+        void set_difference(RedBlackTree&& that)
+        {
+            check_same_allocator(that.alloc);
+            reset_root(difference_subtree(whole_tree(), that.whole_tree(), 0));
+            that.reset_root(Subtree{});
+        }
+
+        // As with the standard containers, allocators that do not propagate on swap
+        // must compare equal.
+        void swap(RedBlackTree& that) noexcept
+        {
+            adopt<typename alloc_traits::propagate_on_container_swap>(that);
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return alloc;
+        }
+
+        void clear()
+        {
+            destroy_subtree(root);
+            root = nullptr;
+            rightmost = nullptr;
+        }
+
+        RedBlackShape shape() const
+        {
+            RedBlackShape result{};
+            shape_subtree(root, 0, result);
+            result.height = result.depthHistogram.size();
+            for(node_type* position{root}; position; position = position->left)
+            {
+                result.blackHeight += !is_node_red(position);
+            }
+            return result;
+        }
+
+        // Walks the whole tree and throws std::logic_error naming the first broken invariant.
+        void validate() const
+        {
+            if(is_node_red(root))
+            {
+                throw std::logic_error{"Error: red root."};
+            }
+            if(root 
+               && root->get_parent())
+            {
+                throw std::logic_error{"Error: root has a parent."};
+            }
+            validate_subtree(root, nullptr, nullptr);
+            if(rightmost != (root? lookup_maximum(root) : nullptr))
+            {
+                throw std::logic_error{"Error: stale rightmost node."};
+            }
+        }
+
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+        std::uint64_t event_count(RedBlackEvent event) const noexcept
+        {
+            return (*events)[static_cast<std::size_t>(event)].load(std::memory_order_relaxed);
+        }
+
+        void reset_event_counts() noexcept
+        {
+            for(auto& counter : *events)
+            {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+#endif
+    private:
+        struct BatchWalk
+        {
+            node_type* node{nullptr};
+            size_type index{0};
+        };
+
+        static constexpr size_type batchWidth{16};
+
+        void count_event([[maybe_unused]] RedBlackEvent event) const noexcept
+        {
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+            (*events)[static_cast<std::size_t>(event)].fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+
+        template<typename Left, typename Right>
+        bool key_less(const Left& left, const Right& right) const
+        {
+            count_event(RedBlackEvent::comparison);
+            return compare(left, right);
+        }
+
+        static void shape_subtree(node_type* node, size_type depth, RedBlackShape& result)
+        {
+            for(; node; node = node->right, ++depth)
+            {
+                if(result.depthHistogram.size() <= depth)
+                {
+                    result.depthHistogram.resize(depth + 1);
+                }
+                ++result.depthHistogram[depth];
+                ++result.size;
+                shape_subtree(node->left, depth + 1, result);
+            }
+        }
+
+        size_type validate_subtree(node_type* node, node_type* lower, node_type* upper) const
+        {
+            if(node == nullptr)
+            {
+                return 0;
+            }
+            if((lower && !compare(lower->key, node->key))
+               || (upper && !compare(node->key, upper->key)))
+            {
+                throw std::logic_error{"Error: keys out of order."};
+            }
+            if(is_node_red(node)
+               && (is_node_red(node->left) || is_node_red(node->right)))
+            {
+                throw std::logic_error{"Error: red node with red child."};
+            }
+            if((node->left && node->left->get_parent() != node)
+               || (node->right && node->right->get_parent() != node))
+            {
+                throw std::logic_error{"Error: broken parent link."};
+            }
+            size_type leftHeight{validate_subtree(node->left, lower, node)};
+            size_type rightHeight{validate_subtree(node->right, node, upper)};
+            if(leftHeight != rightHeight)
+            {
+                throw std::logic_error{"Error: unequal black heights."};
+            }
+            return leftHeight + !is_node_red(node);
+        }
+
+        struct Subtree
+        {
+            node_type* node{nullptr};
+            size_type blackHeight{0};
+        };
+
+        static constexpr size_type parallelBlackHeight{10};
+
+        static size_type parallel_depth() noexcept
+        {
+            static const size_type depth{static_cast<size_type>(std::bit_width(std::thread::hardware_concurrency())) + 1};
+            return depth;
+        }
+
+        Subtree whole_tree() const noexcept
         {
+            size_type blackHeight{0};
+            for(node_type* position{root}; position; position = position->left)
+            {
+                blackHeight += !is_node_red(position);
+            }
+            return Subtree{root, blackHeight};
         }
 
-        RedBlackNode* parent;
-        RedBlackNode* left;
-        RedBlackNode* right;
-        RedBlackColor color;
-        const Key key;
-        Type data;
-    };
+        void reset_root(Subtree tree) noexcept
+        {
+            root = tree.node;
+            rightmost = nullptr;
+            if(root)
+            {
+                root->set_parent(nullptr);
+                root->set_color(RedBlackColor::black);
+                rightmost = lookup_maximum(root);
+            }
+        }
 
-    template<typename Key, 
-             typename Type, 
-             typename Compare = std::less<Key>>
-    class RedBlackTree
-    {
-    public:
-        using key_type = Key;
-        using value_type = Type;
-        using size_type = std::size_t;
-        using key_compare = Compare;
-        using difference_type = std::ptrdiff_t;
-        using node_type = RedBlackNode<Key, Type>;
-        using allocator_type = std::allocator<node_type>;
-        using reference = value_type&;
-        using const_reference = const value_type&; 
-        using pointer = value_type*;
-        using const_pointer = const value_type*;
-        using iterator = node_type*;
+        template<typename KeyArg, typename... Args>
+        iterator try_emplace_key(KeyArg&& key, Args&&... args)
+        {
+            node_type* parent{nullptr};
+            node_type** position{lookup_position(key, &parent, &root)};
+            if(*position != nullptr)
+            {
+                return iterator{*position};
+            }
+            return iterator{construct_at_position(position, parent, key_type(std::forward<KeyArg>(key)), std::forward<Args>(args)...)};
+        }
 
-        RedBlackTree() 
-            : root{nullptr}, alloc{}
-            , compare{}
+        template<typename Lookup>
+        node_type* find_node(const Lookup& key) const
         {
+            node_type* parent{nullptr};
+            node_type* position{root};
+            return *lookup_position(key, &parent, &position);
         }
-        
-        ~RedBlackTree() 
+
+        template<typename Lookup>
+        node_type* lower_bound_node(const Lookup& key) const
         {
-            clear();
+            node_type* bound{nullptr};
+            node_type* position{root};
+            while(position)
+            {
+                if(key_less(position->key, key))
+                {
+                    position = position->right;
+                }
+                else
+                {
+                    bound = position;
+                    position = position->left;
+                }
+            }
+            return bound;
         }
-        
-        template<typename... Args>
-        iterator emplace(const key_type& key, Args&&... args)
+
+        template<typename Lookup>
+        node_type* upper_bound_node(const Lookup& key) const
         {
-            node_type* parent{nullptr};
-            node_type** position{lookup_position(key, &parent, &root)};
-            if(*position == nullptr)
+            node_type* bound{nullptr};
+            node_type* position{root};
+            while(position)
             {
-                *position = std::allocator_traits<allocator_type>::allocate(alloc, 1);
-                std::allocator_traits<allocator_type>::construct(alloc, *position, parent, nullptr, nullptr, 
-                                                                 RedBlackColor::red, key, std::forward<Args>(args)...);
-                insert_fixup(*position);
+                if(key_less(key, position->key))
+                {
+                    bound = position;
+                    position = position->left;
+                }
+                else
+                {
+                    position = position->right;
+                }
             }
-            return iterator{*position};
+            return bound;
         }
 
-        iterator insert(const key_type& key, const value_type& value)
+        void remove_node(node_type* found)
         {
-            return emplace(key, value);
+            if(found)
+            {
+                delete_condition(found);
+                destroy_node(found);
+            }
         }
-        
-        void remove(const key_type& key)
+
+        node_handle extract_node(node_type* found)
         {
-            node_type* found{nullptr};
-            lookup_position(key, &found, &root);
             if(found == nullptr)
             {
-                return;
+                return node_handle{};
             }
             delete_condition(found);
-            std::allocator_traits<allocator_type>::destroy(alloc, found);
-            std::allocator_traits<allocator_type>::deallocate(alloc, found, 1);
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+            return node_handle{found, alloc, events};
+#else
+            return node_handle{found, alloc};
+#endif
         }
 
-        reference operator[](const key_type& ref)
+        template<typename KeyArg, typename... Args>
+        node_type* construct_at_position(node_type** position, node_type* parent, KeyArg&& key, Args&&... args)
         {
-            return *insert(ref, value_type{});
+            count_event(RedBlackEvent::allocation);
+            node_type* fresh{std::allocator_traits<allocator_type>::allocate(alloc, 1)};
+            std::allocator_traits<allocator_type>::construct(alloc, fresh, parent, nullptr, nullptr, 
+                                                             RedBlackColor::red, std::forward<KeyArg>(key), std::forward<Args>(args)...);
+            *position = fresh;
+            insert_rebalance(fresh);
+            return fresh;
         }
 
-        void clear()
+        void insert_rebalance(node_type* fresh)
         {
+            if(rightmost == nullptr
+               || key_less(rightmost->key, fresh->key))
+            {
+                rightmost = fresh;
+            }
+            update_augment_path(fresh->get_parent());
+            insert_fixup(fresh);
         }
-    private:
-        node_type** lookup_position(const key_type& key, node_type** parent, node_type** pos) const
+
+        node_type** hint_position(node_type* hint, const key_type& key, node_type** parent)
+        {
+            if(hint == nullptr)
+            {
+                if(rightmost
+                   && key_less(rightmost->key, key))
+                {
+                    *parent = rightmost;
+                    return &rightmost->right;
+                }
+            }
+            else if(key_less(key, hint->key))
+            {
+                node_type* before{hint->left? lookup_maximum(hint->left) : lookup_predecessor_ancestor(hint)};
+                if(before == nullptr
+                   || key_less(before->key, key))
+                {
+                    *parent = hint->left? before : hint;
+                    return hint->left? &before->right : &hint->left;
+                }
+            }
+            *parent = nullptr;
+            return lookup_position(key, parent, &root);
+        }
+
+        static node_type* lookup_predecessor_ancestor(node_type* node) noexcept
+        {
+            while(node->get_parent()
+                  && node->get_parent()->left == node)
+            {
+                node = node->get_parent();
+            }
+            return node->get_parent();
+        }
+
+        std::pair<Subtree, Subtree> expose(Subtree tree) const noexcept
+        {
+            size_type blackHeight{tree.blackHeight - !is_node_red(tree.node)};
+            return {Subtree{tree.node->left, blackHeight}, Subtree{tree.node->right, blackHeight}};
+        }
+
+        static void update_augment(node_type* node) noexcept
+        {
+            if constexpr(AugmentedRedBlackNode<node_type>)
+            {
+                node->update_augment();
+            }
+        }
+
+        static void update_augment_path(node_type* node) noexcept
+        {
+            if constexpr(AugmentedRedBlackNode<node_type>)
+            {
+                for(; node; node = node->get_parent())
+                {
+                    node->update_augment();
+                }
+            }
+        }
+
+        static void link(node_type* node, node_type* left, node_type* right) noexcept
+        {
+            node->left = left;
+            node->right = right;
+            if(left)
+            {
+                left->set_parent(node);
+            }
+            if(right)
+            {
+                right->set_parent(node);
+            }
+            update_augment(node);
+        }
+
+        node_type* subtree_left_rotation(node_type* node) noexcept
+        {
+            count_event(RedBlackEvent::rotation);
+            node_type* rightChild{node->right};
+            link(node, node->left, rightChild->left);
+            link(rightChild, node, rightChild->right);
+            return rightChild;
+        }
+
+        node_type* subtree_right_rotation(node_type* node) noexcept
+        {
+            count_event(RedBlackEvent::rotation);
+            node_type* leftChild{node->left};
+            link(node, leftChild->right, node->right);
+            link(leftChild, leftChild->left, node);
+            return leftChild;
+        }
+
+        Subtree join_right(Subtree lower, node_type* middle, Subtree upper)
+        {
+            if(!is_node_red(lower.node) && lower.blackHeight == upper.blackHeight)
+            {
+                middle->set_color(RedBlackColor::red);
+                link(middle, lower.node, upper.node);
+                return Subtree{middle, lower.blackHeight};
+            }
+            node_type* top{lower.node};
+            Subtree joined{join_right(expose(lower).second, middle, upper)};
+            link(top, top->left, joined.node);
+            if(!is_node_red(top) 
+               && is_node_red(top->right) 
+               && is_node_red(top->right->right))
+            {
+                top->right->right->set_color(RedBlackColor::black);
+                top = subtree_left_rotation(top);
+            }
+            return Subtree{top, lower.blackHeight};
+        }
+
+        Subtree join_left(Subtree lower, node_type* middle, Subtree upper)
+        {
+            if(!is_node_red(upper.node) && lower.blackHeight == upper.blackHeight)
+            {
+                middle->set_color(RedBlackColor::red);
+                link(middle, lower.node, upper.node);
+                return Subtree{middle, upper.blackHeight};
+            }
+            node_type* top{upper.node};
+            Subtree joined{join_left(lower, middle, expose(upper).first)};
+            link(top, joined.node, top->right);
+            if(!is_node_red(top) 
+               && is_node_red(top->left) 
+               && is_node_red(top->left->left))
+            {
+                top->left->left->set_color(RedBlackColor::black);
+                top = subtree_right_rotation(top);
+            }
+            return Subtree{top, upper.blackHeight};
+        }
+
+        Subtree join_subtree(Subtree lower, node_type* middle, Subtree upper)
+        {
+            Subtree joined{};
+            if(lower.blackHeight > upper.blackHeight)
+            {
+                joined = join_right(lower, middle, upper);
+                if(is_node_red(joined.node) && is_node_red(joined.node->right))
+                {
+                    joined.node->set_color(RedBlackColor::black);
+                    ++joined.blackHeight;
+                }
+            }
+            else if(lower.blackHeight < upper.blackHeight)
+            {
+                joined = join_left(lower, middle, upper);
+                if(is_node_red(joined.node) && is_node_red(joined.node->left))
+                {
+                    joined.node->set_color(RedBlackColor::black);
+                    ++joined.blackHeight;
+                }
+            }
+            else
+            {
+                bool isBlackEnough{!is_node_red(lower.node) && !is_node_red(upper.node)};
+                middle->set_color(isBlackEnough? RedBlackColor::red : RedBlackColor::black);
+                link(middle, lower.node, upper.node);
+                joined = Subtree{middle, lower.blackHeight + !isBlackEnough};
+            }
+            joined.node->set_parent(nullptr);
+            return joined;
+        }
+
+        std::pair<Subtree, node_type*> split_last(Subtree tree)
+        {
+            node_type* top{tree.node};
+            auto [left, right]{expose(tree)};
+            if(right.node == nullptr)
+            {
+                return {left, top};
+            }
+            auto [rest, last]{split_last(right)};
+            return {join_subtree(left, top, rest), last};
+        }
+
+        Subtree join2_subtree(Subtree lower, Subtree upper)
+        {
+            if(lower.node == nullptr)
+            {
+                return upper;
+            }
+            auto [rest, last]{split_last(lower)};
+            return join_subtree(rest, last, upper);
+        }
+
+        std::tuple<Subtree, node_type*, Subtree> split_subtree(Subtree tree, const key_type& key)
+        {
+            if(tree.node == nullptr)
+            {
+                return {Subtree{}, nullptr, Subtree{}};
+            }
+            node_type* top{tree.node};
+            auto [left, right]{expose(tree)};
+            if(key_less(key, top->key))
+            {
+                auto [lower, found, upper]{split_subtree(left, key)};
+                return {lower, found, join_subtree(upper, top, right)};
+            }
+            if(key_less(top->key, key))
+            {
+                auto [lower, found, upper]{split_subtree(right, key)};
+                return {join_subtree(left, top, lower), found, upper};
+            }
+            return {left, top, right};
+        }
+
+        // Runs leftTask on another thread near the top of a large recursion. Both tasks
+        // free nodes of this tree, so the fork is compiled in only for allocators that
+        // tolerate concurrent deallocation.
+        template<typename LeftTask, typename RightTask>
+        std::pair<Subtree, Subtree> fork_join(size_type depth, Subtree pivot, LeftTask leftTask, RightTask rightTask)
+        {
+            if constexpr(ThreadSafeAllocator<allocator_type>::value)
+            {
+                if(depth < parallel_depth() 
+                   && pivot.blackHeight >= parallelBlackHeight)
+                {
+                    auto left{std::async(std::launch::async, leftTask)};
+                    Subtree right{rightTask()};
+                    return {left.get(), right};
+                }
+            }
+            Subtree left{leftTask()};
+            return {left, rightTask()};
+        }
+
+        Subtree union_subtree(Subtree lhs, Subtree rhs, size_type depth)
+        {
+            if(lhs.node == nullptr)
+            {
+                return rhs;
+            }
+            if(rhs.node == nullptr)
+            {
+                return lhs;
+            }
+            node_type* pivot{rhs.node};
+            auto [rhsLeft, rhsRight]{expose(rhs)};
+            auto [lhsLeft, found, lhsRight]{split_subtree(lhs, pivot->key)};
+            auto [left, right]{fork_join(depth, rhs,
+                [&, lower = lhsLeft]{ return union_subtree(lower, rhsLeft, depth + 1); },
+                [&, upper = lhsRight]{ return union_subtree(upper, rhsRight, depth + 1); })};
+            if(found)
+            {
+                destroy_node(pivot);
+                pivot = found;
+            }
+            return join_subtree(left, pivot, right);
+        }
+
+        Subtree intersection_subtree(Subtree lhs, Subtree rhs, size_type depth)
+        {
+            if(lhs.node == nullptr 
+               || rhs.node == nullptr)
+            {
+                destroy_subtree(lhs.node);
+                destroy_subtree(rhs.node);
+                return Subtree{};
+            }
+            node_type* pivot{rhs.node};
+            auto [rhsLeft, rhsRight]{expose(rhs)};
+            auto [lhsLeft, found, lhsRight]{split_subtree(lhs, pivot->key)};
+            auto [left, right]{fork_join(depth, rhs,
+                [&, lower = lhsLeft]{ return intersection_subtree(lower, rhsLeft, depth + 1); },
+                [&, upper = lhsRight]{ return intersection_subtree(upper, rhsRight, depth + 1); })};
+            destroy_node(pivot);
+            if(found)
+            {
+                return join_subtree(left, found, right);
+            }
+            return join2_subtree(left, right);
+        }
+
+        Subtree difference_subtree(Subtree lhs, Subtree rhs, size_type depth)
+        {
+            if(lhs.node == nullptr 
+               || rhs.node == nullptr)
+            {
+                destroy_subtree(rhs.node);
+                return lhs;
+            }
+            node_type* pivot{rhs.node};
+            auto [rhsLeft, rhsRight]{expose(rhs)};
+            auto [lhsLeft, found, lhsRight]{split_subtree(lhs, pivot->key)};
+            auto [left, right]{fork_join(depth, rhs,
+                [&, lower = lhsLeft]{ return difference_subtree(lower, rhsLeft, depth + 1); },
+                [&, upper = lhsRight]{ return difference_subtree(upper, rhsRight, depth + 1); })};
+            destroy_node(pivot);
+            if(found)
+            {
+                destroy_node(found);
+            }
+            return join2_subtree(left, right);
+        }
+
+        node_type* copy_subtree(node_type* source, node_type* parent)
+        {
+            if(source == nullptr)
+            {
+                return nullptr;
+            }
+            count_event(RedBlackEvent::allocation);
+            node_type* copy{std::allocator_traits<allocator_type>::allocate(alloc, 1)};
+            std::allocator_traits<allocator_type>::construct(alloc, copy, parent, nullptr, nullptr, 
+                                                             source->get_color(), source->key, source->data);
+            copy->left = copy_subtree(source->left, copy);
+            copy->right = copy_subtree(source->right, copy);
+            update_augment(copy);
+            return copy;
+        }
+
+        void destroy_node(node_type* node)
+        {
+            count_event(RedBlackEvent::deallocation);
+            std::allocator_traits<allocator_type>::destroy(alloc, node);
+            std::allocator_traits<allocator_type>::deallocate(alloc, node, 1);
+        }
+
+        static void for_each_node_subtree(node_type* node, std::vector<node_type*>& nodes)
+        {
+            while(node)
+            {
+                for_each_node_subtree(node->left, nodes);
+                nodes.push_back(node);
+                node = node->right;
+            }
+        }
+
+        template<typename Function>
+        static void for_each_subtree(node_type* node, Function& function)
+        {
+            while(node)
+            {
+                for_each_subtree(node->left, function);
+                function(node->key, node->data);
+                node = node->right;
+            }
+        }
+
+        void destroy_subtree(node_type* node)
+        {
+            while(node)
+            {
+                destroy_subtree(node->right);
+                node_type* left{node->left};
+                destroy_node(node);
+                node = left;
+            }
+        }
+
+        template<typename Lookup>
+        node_type** lookup_position(const Lookup& key, node_type** parent, node_type** pos) const
         {
             while(*pos) 
             {
                 *parent = *pos;
-                if(compare(key, (*pos)->key))
+                if(key_less(key, (*pos)->key))
                 {
                     pos = &(*pos)->left;
                 }
-                else if(compare((*pos)->key, key))
+                else if(key_less((*pos)->key, key))
                 {
                     pos = &(*pos)->right;
                 }
@@ -148,23 +1386,28 @@ namespace algo
         {
             node_type* start{nullptr};
             node_type* parent{nullptr};
-            RedBlackColor color{target->color};
+            RedBlackColor color{target->get_color()};
+            if(target == rightmost)
+            {
+                rightmost = target->left? lookup_maximum(target->left) : target->get_parent();
+            }
             if(target->left == nullptr)
             {
                 start = target->right;
-                parent = target->parent;
+                parent = target->get_parent();
                 delete_transplant(target, target->right);
             }
             else if(target->right == nullptr)
             {
                 start = target->left;
-                parent = target->parent;
+                parent = target->get_parent();
                 delete_transplant(target, target->left);
             }
             else
             {
                 color = delete_condition_case3(target, &start, &parent);
             }
+            update_augment_path(parent);
             if(color == RedBlackColor::black)
             {
                 delete_fixup(start, parent);
@@ -174,20 +1417,20 @@ namespace algo
         RedBlackColor delete_condition_case3(node_type* target, node_type** start, node_type** parent)
         {
             auto found{lookup_maximum(target->left)};
-            auto color{found->color};
+            auto color{found->get_color()};
             *start = found->left;
             *parent = found;
             if(found != target->left)
             {
-                *parent = found->parent;
+                *parent = found->get_parent();
                 delete_transplant(found, found->left);
-                found->left = target->left;
-                found->left->parent = found;
+                store_link(found->left, target->left);
+                found->left->set_parent(found);
             }
             delete_transplant(target, found);
-            found->right = target->right;
-            found->right->parent = found;
-            found->color = target->color;
+            store_link(found->right, target->right);
+            found->right->set_parent(found);
+            found->set_color(target->get_color());
             return color;
         }
         
@@ -195,19 +1438,19 @@ namespace algo
         {
             if(target == root)
             {
-                root = replacement;
+                store_link(root, replacement);
             }
             else if(is_left_child(target))
             {
-                target->parent->left = replacement;
+                store_link(target->get_parent()->left, replacement);
             }
             else 
             {
-                target->parent->right = replacement;
+                store_link(target->get_parent()->right, replacement);
             }
             if(replacement)
             {
-                replacement->parent = target->parent;
+                replacement->set_parent(target->get_parent());
             }
         }
 
@@ -222,17 +1465,11 @@ namespace algo
         
         void delete_fixup(node_type* start, node_type* parent)
         {
-            if(parent == nullptr)
-            {
-                return;
-            }
-            bool isSiblingRight{parent->left == start};
-            node_type* sibling{isSiblingRight? parent->right : parent->left};
             while(start != root 
                   && !is_node_red(start))
             {
-                isSiblingRight = parent->left == start;
-                sibling = isSiblingRight? parent->right : parent->left;
+                bool isSiblingRight{parent->left == start};
+                node_type* sibling{isSiblingRight? parent->right : parent->left};
                 if(is_node_red(sibling))
                 {
                     sibling = delete_fixup_case1(sibling, parent, isSiblingRight);
@@ -244,9 +1481,10 @@ namespace algo
                 if(!is_node_red(sibling->left)
                    && !is_node_red(sibling->right))
                 {
-                    sibling->color = RedBlackColor::red;
+                    count_event(RedBlackEvent::delete_fixup_case2);
+                    sibling->set_color(RedBlackColor::red);
                     start = parent;
-                    parent = start->parent;
+                    parent = start->get_parent();
                 }
                 else
                 {
@@ -258,14 +1496,18 @@ namespace algo
                     delete_fixup_case4(sibling, parent, isSiblingRight);
                     start = root;
                 }
-                start->color = RedBlackColor::black;
+            }
+            if(start)
+            {
+                start->set_color(RedBlackColor::black);
             }
         }
 
         node_type* delete_fixup_case1(node_type* sibling, node_type* parent, bool isSiblingRight)
         {
-            sibling->color = RedBlackColor::black;
-            parent->color = RedBlackColor::red;
+            count_event(RedBlackEvent::delete_fixup_case1);
+            sibling->set_color(RedBlackColor::black);
+            parent->set_color(RedBlackColor::red);
             if(isSiblingRight)
             {
                 left_rotation(parent);
@@ -277,57 +1519,59 @@ namespace algo
         
         node_type* delete_fixup_case3(node_type* sibling, node_type* parent, bool isSiblingRight)
         {
-            sibling->color = RedBlackColor::red;
+            count_event(RedBlackEvent::delete_fixup_case3);
+            sibling->set_color(RedBlackColor::red);
             if(isSiblingRight)
             {
-                sibling->left->color = RedBlackColor::black;
+                sibling->left->set_color(RedBlackColor::black);
                 right_rotation(sibling);
                 return parent->right;
             }
-            sibling->right->color = RedBlackColor::black;
+            sibling->right->set_color(RedBlackColor::black);
             left_rotation(sibling);
             return parent->left;
         }
 
         void delete_fixup_case4(node_type* sibling, node_type* parent, bool isSiblingRight)
         {
-            sibling->color = parent->color;
-            parent->color = RedBlackColor::black;
+            count_event(RedBlackEvent::delete_fixup_case4);
+            sibling->set_color(parent->get_color());
+            parent->set_color(RedBlackColor::black);
             if(isSiblingRight)
             {
-                sibling->right->color = RedBlackColor::black;
+                sibling->right->set_color(RedBlackColor::black);
                 left_rotation(parent);
             }
             else
             {
-                sibling->left->color = RedBlackColor::black;
+                sibling->left->set_color(RedBlackColor::black);
                 right_rotation(parent);
             }
         }
 
         void insert_fixup(node_type* position)
         {
-            while(is_node_red(position->parent)) 
+            while(is_node_red(position->get_parent())) 
             {
                 node_type* uncle{lookup_uncle(position)};
                 if(is_node_red(uncle))
                 {
-                    insert_fixup_case1(position->parent, uncle);
-                    position = position->parent->parent;
+                    insert_fixup_case1(position->get_parent(), uncle);
+                    position = position->get_parent()->get_parent();
                 }
                 else
                 {
                     insert_fixup_black_uncle(&position);
                 }
             }
-            root->color = RedBlackColor::black;
+            root->set_color(RedBlackColor::black);
         }
         
         void insert_fixup_black_uncle(node_type** position)
         {
-            if(is_left_child(*position) != is_left_child((*position)->parent))
+            if(is_left_child(*position) != is_left_child((*position)->get_parent()))
             {
-                node_type* remember{(*position)->parent};
+                node_type* remember{(*position)->get_parent()};
                 insert_fixup_case2(*position);
                 *position = remember;
             }
@@ -339,9 +1583,10 @@ namespace algo
         
         void insert_fixup_case1(node_type* parent, node_type* uncle)
         {
+            count_event(RedBlackEvent::insert_fixup_case1);
             recolor(parent);
             recolor(uncle);
-            recolor(parent->parent);
+            recolor(parent->get_parent());
             if(is_node_red(root))
             {
                 recolor(root);
@@ -350,39 +1595,41 @@ namespace algo
         
         void insert_fixup_case2(node_type* node)
         {
+            count_event(RedBlackEvent::insert_fixup_case2);
             if(is_left_child(node))
             {
-                right_rotation(node->parent);
+                right_rotation(node->get_parent());
             }
             else 
             {
-                left_rotation(node->parent);
+                left_rotation(node->get_parent());
             }
         }
 
         void insert_fixup_case3(node_type* node)
         {
-            recolor(node->parent);
-            recolor(node->parent->parent);
-            if(is_left_child(node->parent))
+            count_event(RedBlackEvent::insert_fixup_case3);
+            recolor(node->get_parent());
+            recolor(node->get_parent()->get_parent());
+            if(is_left_child(node->get_parent()))
             {
-                right_rotation(node->parent->parent);
+                right_rotation(node->get_parent()->get_parent());
             }
             else 
             {
-                left_rotation(node->parent->parent);
+                left_rotation(node->get_parent()->get_parent());
             }
         }
         
         void recolor(node_type* node)
         {
-            switch(node->color)
+            switch(node->get_color())
             {
             case RedBlackColor::red:
-                node->color = RedBlackColor::black;
+                node->set_color(RedBlackColor::black);
                 break;
             case RedBlackColor::black:
-                node->color = RedBlackColor::red;
+                node->set_color(RedBlackColor::red);
                 break;
             default:
                 break;
@@ -391,70 +1638,83 @@ namespace algo
         
         node_type* lookup_uncle(node_type* node)
         {
-            if(is_left_child(node->parent))
+            if(is_left_child(node->get_parent()))
             {
-                return node->parent->parent->right;
+                return node->get_parent()->get_parent()->right;
             }
             else  
             {
-                return node->parent->parent->left;   
+                return node->get_parent()->get_parent()->left;   
             }
         }
         
+        // Links that a rebalance rewrites are stored with release semantics, because the
+        // optimistic readers of ConcurrentRedBlackTree load them while a writer runs.
+        static void store_link(node_type*& link, node_type* fresh) noexcept
+        {
+            std::atomic_ref<node_type*>{link}.store(fresh, std::memory_order_release);
+        }
+
         void left_rotation(node_type* node)
         {   
+            count_event(RedBlackEvent::rotation);
             node_type* rightChild{node->right};
-            rightChild->parent = node->parent;
-            if(rightChild->parent)
+            rightChild->set_parent(node->get_parent());
+            if(rightChild->get_parent())
             {
                 if(is_left_child(node))
                 {
-                    rightChild->parent->left = rightChild;
+                    store_link(rightChild->get_parent()->left, rightChild);
                 }
                 else               
                 {
-                    rightChild->parent->right = rightChild;
+                    store_link(rightChild->get_parent()->right, rightChild);
                 }
             }
-            node->right = rightChild->left;
-            node->parent = rightChild;
-            rightChild->left = node;
+            store_link(node->right, rightChild->left);
+            node->set_parent(rightChild);
+            store_link(rightChild->left, node);
             if(node->right)
             {
-                node->right->parent = node;
+                node->right->set_parent(node);
             }
             if(node == root)
             {
-                root = rightChild;
+                store_link(root, rightChild);
             }
+            update_augment(node);
+            update_augment(rightChild);
         }
     
         void right_rotation(node_type* node)
         {   
+            count_event(RedBlackEvent::rotation);
             node_type* leftChild{node->left};
-            leftChild->parent = node->parent;
-            if(leftChild->parent)
+            leftChild->set_parent(node->get_parent());
+            if(leftChild->get_parent())
             {
                 if(is_left_child(node))
                 {
-                    leftChild->parent->left = leftChild;
+                    store_link(leftChild->get_parent()->left, leftChild);
                 }
                 else               
                 {
-                    leftChild->parent->right = leftChild;
+                    store_link(leftChild->get_parent()->right, leftChild);
                 }
             }
-            node->left = leftChild->right;
-            node->parent = leftChild;
-            leftChild->right = node;
+            store_link(node->left, leftChild->right);
+            node->set_parent(leftChild);
+            store_link(leftChild->right, node);
             if(node->left)
             {
-                node->left->parent = node;
+                node->left->set_parent(node);
             }
             if(node == root)
             {
-                root = leftChild;
+                store_link(root, leftChild);
             }
+            update_augment(node);
+            update_augment(leftChild);
         }
 
         bool is_node_red(node_type* node) const noexcept
@@ -463,17 +1723,70 @@ namespace algo
             {
                 return false;    
             }
-            return node->color == RedBlackColor::red;;
+            return node->get_color() == RedBlackColor::red;;
+        }
+
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        // Swaps contents, and the allocators only when Propagate says they follow them.
+        // Assignments build the replacement with the allocator this tree must end up
+        // with, so a non-propagating one is already equal to ours.
+        template<typename Propagate>
+        void adopt(RedBlackTree& that) noexcept
+        {
+            std::swap(this->root, that.root);
+            std::swap(this->rightmost, that.rightmost);
+            if constexpr(Propagate::value)
+            {
+                std::swap(this->alloc, that.alloc);
+            }
+            std::swap(this->compare, that.compare);
+        }
+
+        // Nodes only move between trees whose allocators can free each other's nodes.
+        void check_same_allocator(const allocator_type& other) const
+        {
+            if constexpr(!alloc_traits::is_always_equal::value)
+            {
+                if(alloc != other)
+                {
+                    throw std::invalid_argument{"Error: trees use different allocators."};
+                }
+            }
         }
 
         bool is_left_child(node_type* node) const noexcept
         {
-            return node->parent->left == node;
+            return node->get_parent()->left == node;
         }
 
         node_type* root;
+        node_type* rightmost;
         allocator_type alloc;
         key_compare compare;
+#if defined(ALGO_RED_BLACK_TREE_STATS)
+        std::shared_ptr<EventCounters> events{std::make_shared<EventCounters>()};
+#endif
     };
+
+    template<typename Key, 
+             typename Type, 
+             typename Compare = std::less<Key>>
+    using CompactRedBlackTree = RedBlackTree<Key, Type, Compare, PackedRedBlackNode<Key, Type>>;
+
+    namespace pmr
+    {
+        template<typename Key, 
+                 typename Type, 
+                 typename Compare = std::less<Key>>
+        using RedBlackTree = algo::RedBlackTree<Key, Type, Compare, RedBlackNode<Key, Type>, 
+                                                std::pmr::polymorphic_allocator<RedBlackNode<Key, Type>>>;
+
+        template<typename Key, 
+                 typename Type, 
+                 typename Compare = std::less<Key>>
+        using CompactRedBlackTree = algo::RedBlackTree<Key, Type, Compare, PackedRedBlackNode<Key, Type>, 
+                                                       std::pmr::polymorphic_allocator<PackedRedBlackNode<Key, Type>>>;
+    }
 }   
 #endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef SCRATCH_DIRECTORY_H
+#define SCRATCH_DIRECTORY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace algo
+{
+    // A freshly created, uniquely named directory under parent, removed with everything
+    // in it when the object goes away. A random name alone can collide, and on some
+    // platforms random_device is deterministic, so the name also mixes in the clock and
+    // create_directory must report that it made the directory; a name that already
+    // exists is never reused, another one is drawn instead.
+    class ScratchDirectory
+    {
+    public:
+        static constexpr std::size_t maxAttempts{64};
+
+        ScratchDirectory(const std::filesystem::path& parent, const std::string& prefix)
+        {
+            std::filesystem::create_directories(parent);
+            std::random_device seed;
+            std::mt19937_64 engine{(std::uint64_t{seed()} << 32 | seed())
+                                   ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())};
+            for(std::size_t attempt{0}; attempt < maxAttempts; ++attempt)
+            {
+                std::filesystem::path candidate{parent / (prefix + std::to_string(engine()))};
+                if(std::filesystem::create_directory(candidate))
+                {
+                    directory = std::move(candidate);
+                    return;
+                }
+            }
+            throw std::runtime_error{"Error: cannot create a scratch directory in " + parent.string()};
+        }
+
+        ScratchDirectory(const ScratchDirectory&) = delete;
+        ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+        ~ScratchDirectory()
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(directory, ignored);
+        }
+
+        const std::filesystem::path& path() const noexcept
+        {
+            return directory;
+        }
+    private:
+        std::filesystem::path directory;
+    };
+}
+
+#endif
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../source/dary_heap.h"
+#include "../source/fibonacci_heap.h"
+#include "../source/node_pool.h"
+#include "../source/pairing_heap.h"
+#include "../source/radix_heap.h"
+
+namespace
+{
+    using Entry = std::pair<std::uint64_t, std::uint32_t>;
+
+    template<typename Heap>
+    class addressable_heap_test : public testing::Test
+    {
+    };
+
+    using Heaps = testing::Types<algo::fibonacci_heap<Entry>,
+                                 algo::pairing_heap<Entry>,
+                                 algo::dary_heap<Entry>,
+                                 algo::dary_heap<Entry, std::less<Entry>, 2>,
+                                 algo::radix_heap<Entry>>;
+
+    static_assert(algo::AddressableHeap<algo::fibonacci_heap<Entry>>);
+    static_assert(algo::AddressableHeap<algo::pairing_heap<Entry>>);
+    static_assert(algo::AddressableHeap<algo::dary_heap<Entry>>);
+    static_assert(algo::AddressableHeap<algo::radix_heap<Entry>>);
+}
+
+TYPED_TEST_SUITE(addressable_heap_test, Heaps);
+
+namespace
+{
+    template<typename Heap>
+    class pooled_heap_test : public testing::Test
+    {
+    };
+
+    using PooledHeaps = testing::Types<algo::fibonacci_heap<Entry>,
+                                       algo::pairing_heap<Entry>>;
+}
+
+TYPED_TEST_SUITE(pooled_heap_test, PooledHeaps);
+
+TYPED_TEST(addressable_heap_test, monotone_workload)
+{
+    std::mt19937_64 engine{41};
+    TypeParam heap;
+    std::set<Entry> expected;
+    std::map<std::uint32_t, typename TypeParam::handle> handles;
+    std::map<std::uint32_t, Entry> keys;
+    std::uint64_t floor{0};
+    for(std::uint32_t step{0}; step < 40000; ++step)
+    {
+        switch(engine() % 6)
+        {
+        case 0:
+        case 1:
+        case 2:
+        {
+            Entry key{floor + engine() % 5000, step};
+            handles[step] = heap.push(key);
+            keys[step] = key;
+            expected.insert(key);
+            break;
+        }
+        case 3:
+            if(!expected.empty())
+            {
+                Entry top{*expected.begin()};
+                ASSERT_EQ(heap.top().first, top.first);
+                Entry popped{heap.top()};
+                heap.pop();
+                expected.erase(popped);
+                handles.erase(popped.second);
+                keys.erase(popped.second);
+                floor = popped.first;
+            }
+            break;
+        case 4:
+            if(!handles.empty())
+            {
+                auto entry{handles.begin()};
+                std::advance(entry, engine() % handles.size());
+                Entry key{keys[entry->first]};
+                expected.erase(key);
+                key.first = floor + (key.first - floor) / 2;
+                heap.decrease_key(entry->second, key);
+                keys[entry->first] = key;
+                expected.insert(key);
+            }
+            break;
+        default:
+            if(!handles.empty())
+            {
+                auto entry{handles.begin()};
+                std::advance(entry, engine() % handles.size());
+                heap.erase(entry->second);
+                expected.erase(keys[entry->first]);
+                keys.erase(entry->first);
+                handles.erase(entry);
+            }
+            break;
+        }
+        ASSERT_EQ(heap.size(), expected.size());
+    }
+    while(!heap.empty())
+    {
+        ASSERT_EQ(heap.top().first, expected.begin()->first);
+        floor = heap.top().first;
+        expected.erase(heap.top());
+        heap.pop();
+    }
+    EXPECT_TRUE(expected.empty());
+    EXPECT_THROW(heap.top(), std::out_of_range);
+    heap.push(Entry{floor, 0});
+    heap.clear();
+    EXPECT_TRUE(heap.empty());
+}
+
+// Popping leaves long free lists in both pools. Merging chains them together, and
+// the pushes afterwards must drain the combined list through to its tail and then
+// grow, whichever side had free slots.
+TYPED_TEST(pooled_heap_test, merge_after_heavy_popping)
+{
+    std::mt19937_64 engine{43};
+    std::multiset<Entry> expected;
+    TypeParam heap;
+    for(std::uint32_t round{0}; round < 4; ++round)
+    {
+        TypeParam donor;
+        for(std::uint32_t index{0}; index < 20000; ++index)
+        {
+            donor.push(Entry{engine() % 1000000, index});
+            heap.push(Entry{engine() % 1000000, index});
+        }
+        for(std::uint32_t index{0}; index < 19990; ++index)
+        {
+            donor.pop();
+            heap.pop();
+        }
+        if(round % 2 == 1)
+        {
+            while(!heap.empty())
+            {
+                heap.pop();
+            }
+            heap.merge(TypeParam{});
+        }
+        heap.merge(donor);
+        EXPECT_TRUE(donor.empty());
+        for(std::uint32_t index{0}; index < 50000; ++index)
+        {
+            donor.push(Entry{engine() % 1000000, index});
+            heap.push(Entry{engine() % 1000000, index});
+        }
+        heap.merge(donor);
+        while(!heap.empty())
+        {
+            expected.insert(heap.top());
+            heap.pop();
+        }
+        for(const auto& entry : expected)
+        {
+            heap.push(entry);
+        }
+        ASSERT_EQ(heap.size(), expected.size());
+    }
+    for(const auto& entry : expected)
+    {
+        ASSERT_EQ(heap.top(), entry);
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+// A pool whose free list is empty takes over the donor's list and tail; splicing it
+// on into a third pool must link through that tail, not through a live node.
+TEST(node_pool_test, splice_keeps_the_free_list_tail)
+{
+    using Pool = algo::NodePool<std::uint64_t>;
+    Pool full;
+    std::vector<std::uint64_t*> live;
+    for(std::uint64_t value{0}; value < Pool::firstChunkNodes; ++value)
+    {
+        live.push_back(full.create(value));
+    }
+    Pool donor;
+    std::vector<std::uint64_t*> released;
+    for(std::uint64_t value{0}; value < 100; ++value)
+    {
+        released.push_back(donor.create(value));
+    }
+    for(auto* node : released)
+    {
+        donor.destroy(node);
+    }
+    full.splice(donor);
+    Pool merged;
+    merged.destroy(merged.create(std::uint64_t{0}));
+    merged.splice(full);
+    std::set<std::uint64_t*> handedOut;
+    for(std::uint64_t value{0}; value < 1000; ++value)
+    {
+        EXPECT_TRUE(handedOut.insert(merged.create(value)).second);
+    }
+    for(std::uint64_t value{0}; value < live.size(); ++value)
+    {
+        EXPECT_EQ(*live[value], value);
+        EXPECT_FALSE(handedOut.contains(live[value]));
+    }
+    for(auto* node : handedOut)
+    {
+        merged.destroy(node);
+    }
+}
+
+TEST(radix_heap_test, rejects_keys_below_last_pop)
+{
+    algo::radix_heap<std::uint32_t> heap;
+    heap.push(10u);
+    auto handle{heap.push(20u)};
+    heap.pop();
+    EXPECT_THROW(heap.push(5u), std::invalid_argument);
+    EXPECT_THROW(heap.decrease_key(handle, 9u), std::invalid_argument);
+    heap.decrease_key(handle, 10u);
+    EXPECT_EQ(heap.top(), 10u);
+}
+
+TEST(pairing_heap_test, deep_heap_is_destroyed)
+{
+    algo::pairing_heap<int> heap;
+    for(int key{200000}; key > 0; --key)
+    {
+        heap.push(key);
+    }
+    EXPECT_EQ(heap.top(), 1);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
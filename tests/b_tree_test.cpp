@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include "../source/b_tree.h"
+
+TEST(b_tree_test, red_black_tree_surface)
+{
+    algo::BTree<int, int> tree;
+    tree.emplace(1, 10);
+    tree.insert(2, 20);
+    tree[3] = 30;
+    EXPECT_EQ(tree.find(2)->second, 20);
+    EXPECT_EQ(tree[3], 30);
+    tree.remove(2);
+    EXPECT_FALSE(tree.contains(2));
+    EXPECT_EQ(tree.size(), 2);
+}
+
+namespace
+{
+    // Random edits against std::map. Signed 32- and 64-bit keys take the vector
+    // search when the test is built with AVX2.
+    template<typename Key>
+    void check_against_map()
+    {
+        std::mt19937 engine{13};
+        algo::BTree<Key, int> tree;
+        std::map<Key, int> expected;
+        for(int step{0}; step < 50000; ++step)
+        {
+            Key key{static_cast<Key>(engine() % 5000) - 2500};
+            switch(engine() % 3)
+            {
+            case 0:
+                tree.remove(key);
+                expected.erase(key);
+                break;
+            case 1:
+                tree[key] = step;
+                expected[key] = step;
+                break;
+            default:
+                tree.insert(key, step);
+                expected.emplace(key, step);
+                break;
+            }
+        }
+        ASSERT_EQ(tree.size(), expected.size());
+        auto position{expected.begin()};
+        for(auto entry{tree.begin()}; entry != tree.end(); ++entry, ++position)
+        {
+            ASSERT_EQ(entry->first, position->first);
+            ASSERT_EQ(entry->second, position->second);
+        }
+        EXPECT_EQ(tree.lower_bound(expected.begin()->first + 1)->first, std::next(expected.begin())->first);
+    }
+}
+
+TEST(b_tree_test, const_lookups_do_not_hand_out_mutable_values)
+{
+    algo::BTree<int, int> tree;
+    for(int key{0}; key < 100; ++key)
+    {
+        tree.insert(key, key * 10);
+    }
+    const auto& view{tree};
+    static_assert(std::is_same_v<decltype(view.find(1)), algo::BTree<int, int>::const_iterator>);
+    static_assert(std::is_same_v<decltype(view.lower_bound(1)), algo::BTree<int, int>::const_iterator>);
+    static_assert(std::is_same_v<decltype(view.begin()), algo::BTree<int, int>::const_iterator>);
+    static_assert(!std::is_assignable_v<decltype((view.find(1)->second)), int>);
+    EXPECT_EQ(view.find(42)->second, 420);
+    EXPECT_EQ(view.lower_bound(-5)->first, 0);
+    EXPECT_EQ(view.find(100), view.end());
+
+    tree.find(42)->second = 7;
+    algo::BTree<int, int>::const_iterator converted{tree.lower_bound(42)};
+    EXPECT_EQ(converted->second, 7);
+    EXPECT_TRUE(converted == tree.find(42));
+    EXPECT_TRUE(tree.find(42) == converted);
+    int visited{0};
+    for(auto it{view.cbegin()}; it != view.cend(); ++it)
+    {
+        ++visited;
+    }
+    EXPECT_EQ(visited, 100);
+}
+
+TEST(b_tree_test, matches_map)
+{
+    check_against_map<int>();
+}
+
+TEST(b_tree_test, int64_keys_match_map)
+{
+    check_against_map<std::int64_t>();
+}
+
+TEST(b_tree_test, string_keys)
+{
+    algo::BTree<std::string, int> tree;
+    for(int key{0}; key < 1000; ++key)
+    {
+        tree.insert(std::to_string(key), key);
+    }
+    for(int key{0}; key < 1000; key += 3)
+    {
+        tree.remove(std::to_string(key));
+    }
+    for(int key{0}; key < 1000; ++key)
+    {
+        ASSERT_EQ(tree.contains(std::to_string(key)), key % 3 != 0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../source/concurrent_red_black_tree.h"
+
+TEST(concurrent_red_black_tree_test, insert_find_remove)
+{
+    algo::ConcurrentRedBlackTree<int, int> tree;
+    EXPECT_TRUE(tree.insert(1, 10));
+    EXPECT_FALSE(tree.insert(1, 20));
+    EXPECT_EQ(tree.find(1), 10);
+    EXPECT_TRUE(tree.remove(1));
+    EXPECT_FALSE(tree.remove(1));
+    EXPECT_FALSE(tree.contains(1));
+}
+
+TEST(concurrent_red_black_tree_test, range)
+{
+    algo::ConcurrentRedBlackTree<int, int> tree;
+    for(int key{0}; key < 100; ++key)
+    {
+        tree.insert(key, key * 2);
+    }
+    auto found{tree.range(10, 19)};
+    ASSERT_EQ(found.size(), 10);
+    for(int index{0}; index < 10; ++index)
+    {
+        EXPECT_EQ(found[index].first, index + 10);
+        EXPECT_EQ(found[index].second, (index + 10) * 2);
+    }
+}
+
+TEST(concurrent_red_black_tree_test, readers_during_writes)
+{
+    constexpr int stableKeys{1000};
+    algo::ConcurrentRedBlackTree<int, int> tree;
+    for(int key{0}; key < stableKeys; ++key)
+    {
+        tree.insert(key * 2, key);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for(int reader{0}; reader < 4; ++reader)
+    {
+        readers.emplace_back([&]
+        {
+            while(!stop.load())
+            {
+                for(int key{0}; key < stableKeys; key += 7)
+                {
+                    auto found{tree.find(key * 2)};
+                    if(!found || *found != key)
+                    {
+                        ++misses;
+                    }
+                }
+                if(tree.range(0, 2 * stableKeys).size() < stableKeys)
+                {
+                    ++misses;
+                }
+            }
+        });
+    }
+    for(int round{0}; round < 20; ++round)
+    {
+        for(int key{0}; key < stableKeys; ++key)
+        {
+            tree.insert(key * 2 + 1, key);
+        }
+        for(int key{0}; key < stableKeys; ++key)
+        {
+            tree.remove(key * 2 + 1);
+        }
+    }
+    stop = true;
+    for(auto& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(misses.load(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
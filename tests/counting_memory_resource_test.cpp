@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../source/counting_memory_resource.h"
+#include "../source/dynamic_matrix.h"
+#include "../source/red_black_tree.h"
+
+TEST(counting_memory_resource_test, counts_bytes_and_size_classes)
+{
+    algo::CountingMemoryResource resource;
+    std::vector<algo::AllocationEvent> events;
+    resource.set_tracer([&](const algo::AllocationEvent& event)
+    {
+        events.push_back(event);
+    });
+    void* small{resource.allocate(24, 8)};
+    void* large{resource.allocate(1000, 16)};
+    EXPECT_EQ(resource.stats().allocations, 2u);
+    EXPECT_EQ(resource.stats().bytesInUse, 1024u);
+    EXPECT_EQ(resource.stats().sizeHistogram[5], 1u);
+    EXPECT_EQ(resource.stats().sizeHistogram[10], 1u);
+    resource.deallocate(large, 1000, 16);
+    void* again{resource.allocate(100, 8)};
+    EXPECT_EQ(resource.stats().peakBytesInUse, 1024u);
+    EXPECT_EQ(resource.stats().bytesInUse, 124u);
+    resource.deallocate(small, 24, 8);
+    resource.deallocate(again, 100, 8);
+    EXPECT_EQ(resource.stats().bytesAllocated, 1124u);
+    EXPECT_EQ(resource.stats().deallocations, 3u);
+    EXPECT_EQ(resource.stats().bytesInUse, 0u);
+    ASSERT_EQ(events.size(), 6u);
+    EXPECT_EQ(events[2].kind, algo::AllocationEventKind::deallocation);
+    EXPECT_EQ(events[2].address, large);
+    resource.reset_stats();
+    EXPECT_EQ(resource.stats().allocations, 0u);
+}
+
+TEST(counting_memory_resource_test, red_black_tree_uses_its_resource)
+{
+    algo::CountingMemoryResource resource;
+    {
+        algo::pmr::RedBlackTree<int, int> tree{&resource};
+        for(int key{0}; key < 100; ++key)
+        {
+            tree.insert(key, key);
+        }
+        EXPECT_EQ(resource.stats().allocations, 100u);
+        EXPECT_EQ(resource.stats().sizeHistogram[std::bit_width(sizeof(algo::RedBlackNode<int, int>) - 1)], 100u);
+        tree.remove(7);
+        EXPECT_EQ(resource.stats().deallocations, 1u);
+
+        auto handle{tree.extract(3)};
+        decltype(handle) moved;
+        moved = std::move(handle);
+        EXPECT_EQ(moved.key(), 3);
+        tree.insert(std::move(moved));
+        EXPECT_EQ(resource.stats().allocations, 100u);
+
+        auto upper{tree.split(50)};
+        EXPECT_EQ(upper.get_allocator().resource(), &resource);
+        tree.join2(std::move(upper));
+
+        algo::CountingMemoryResource other;
+        algo::pmr::RedBlackTree<int, int> copy{tree, &other};
+        EXPECT_EQ(other.stats().allocations, 99u);
+        EXPECT_THROW(tree.merge(copy), std::invalid_argument);
+
+        // polymorphic_allocator does not propagate, so assignment copies into the target's resource.
+        copy = std::move(tree);
+        EXPECT_EQ(copy.get_allocator().resource(), &other);
+        EXPECT_EQ(other.stats().allocations, 198u);
+        EXPECT_TRUE(copy.contains(99));
+    }
+    EXPECT_EQ(resource.stats().bytesInUse, 0u);
+}
+
+TEST(counting_memory_resource_test, monotonic_buffer_backs_a_tree)
+{
+    std::array<std::byte, 1 << 16> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    algo::CountingMemoryResource resource{&arena};
+    algo::pmr::CompactRedBlackTree<std::int64_t, std::int64_t> tree{&resource};
+    for(std::int64_t key{0}; key < 500; ++key)
+    {
+        tree.insert(key, key * 2);
+    }
+    tree.validate();
+    EXPECT_EQ(resource.stats().allocations, 500u);
+    EXPECT_EQ(resource.upstream_resource(), &arena);
+}
+
+TEST(counting_memory_resource_test, dynamic_matrix_uses_its_resource)
+{
+    algo::CountingMemoryResource resource;
+    {
+        algo::pmr::DynamicMatrix<double> matrix{8, &resource};
+        std::ranges::copy(std::views::iota(0, 64), matrix.begin());
+        EXPECT_EQ(resource.stats().allocations, 1u);
+        EXPECT_EQ(resource.stats().bytesInUse, 64 * sizeof(double));
+        algo::pmr::DynamicMatrix<double> empty{&resource};
+        EXPECT_EQ(resource.stats().allocations, 1u);
+
+        algo::CountingMemoryResource other;
+        algo::pmr::DynamicMatrix<double> moved{std::move(matrix), &other};
+        EXPECT_EQ(other.stats().allocations, 1u);
+        EXPECT_EQ(resource.stats().bytesInUse, 0u);
+        EXPECT_TRUE(std::ranges::equal(moved, std::views::iota(0, 64)));
+
+        empty = moved;
+        EXPECT_EQ(empty.get_allocator().resource(), &resource);
+        EXPECT_EQ(resource.stats().allocations, 2u);
+        EXPECT_EQ((empty[1, 2]), 10.0);
+        EXPECT_TRUE(std::ranges::equal(empty, moved));
+    }
+    EXPECT_EQ(resource.stats().bytesInUse, 0u);
+    EXPECT_EQ(resource.stats().deallocations, 2u);
+}
+
+TEST(counting_memory_resource_test, pmr_set_operations_stay_on_the_calling_thread)
+{
+    algo::CountingMemoryResource resource;
+    const auto caller{std::this_thread::get_id()};
+    std::size_t foreign{0};
+    resource.set_tracer([&](const algo::AllocationEvent&)
+    {
+        foreign += std::this_thread::get_id() != caller;
+    });
+    algo::pmr::RedBlackTree<int, int> lhs{&resource};
+    algo::pmr::RedBlackTree<int, int> rhs{&resource};
+    for(int key{0}; key < 100000; ++key)
+    {
+        lhs.insert(key, key);
+        rhs.insert(key * 2, key);
+    }
+    lhs.set_difference(std::move(rhs));
+    EXPECT_EQ(foreign, 0u);
+    EXPECT_EQ(resource.stats().bytesInUse, 50000 * sizeof(algo::pmr::RedBlackTree<int, int>::node_type));
+    lhs.validate();
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <ranges>
 #include <cstdlib>
-//#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
 #include "../source/dynamic_matrix.h"
 
 /*TEST(dynamic_matrix_test, insert)
@@ -41,6 +43,40 @@ TEST(dynamic_matrix_test, indexing)
     EXPECT_NO_THROW(matrix.at(1, 2));
 }*/
 
+TEST(dynamic_matrix_test, rectangular_layout)
+{
+    algo::DynamicMatrix<int> matrix{2, 3};
+    int value{0};
+    for(std::size_t row{0}; row < matrix.rows(); ++row)
+    {
+        for(std::size_t col{0}; col < matrix.cols(); ++col)
+        {
+            matrix[row, col] = value++;
+        }
+    }
+    EXPECT_EQ(matrix.size(), 6u);
+    EXPECT_EQ(matrix.data()[4], (matrix[1, 1]));
+    EXPECT_TRUE(std::ranges::equal(matrix, std::views::iota(0, 6)));
+    EXPECT_TRUE(std::ranges::equal(std::ranges::subrange(matrix.rbegin(), matrix.rend()), std::views::iota(0, 6) | std::views::reverse));
+    EXPECT_THROW(matrix.at(0, 3), std::out_of_range);
+
+    const algo::DynamicMatrix<int> copy{matrix};
+    EXPECT_TRUE(std::ranges::equal(copy, matrix));
+}
+
+TEST(dynamic_matrix_test, resize)
+{
+    algo::DynamicMatrix<int> matrix{2, 3};
+    std::ranges::copy(std::views::iota(1, 7), matrix.begin());
+    matrix.resize(3, 2);
+    EXPECT_TRUE(std::ranges::equal(matrix, std::vector<int>{1, 2, 4, 5, 0, 0}));
+    matrix.resize(1, 4, false);
+    EXPECT_EQ(matrix.rows(), 1u);
+    EXPECT_TRUE(std::ranges::equal(matrix, std::vector<int>(4, 0)));
+    matrix.resize(0, 0);
+    EXPECT_EQ(matrix.begin(), matrix.end());
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../source/dary_heap.h"
+#include "../source/external_sort.h"
+#include "scratch_directory_fixture.h"
+
+namespace
+{
+    // dary_heap's defaulted arity keeps it from matching HeapMerger's two-parameter
+    // slot without P0522, so it goes through an alias of exactly that shape.
+    template<typename Key, typename Compare>
+    using QuaternaryHeap = algo::dary_heap<Key, Compare>;
+
+    template<typename Key, typename Compare>
+    using QuaternaryMerger = algo::HeapMerger<Key, Compare, QuaternaryHeap>;
+
+    template<typename Merger>
+    class merger_test : public testing::Test
+    {
+    };
+
+    using Mergers = testing::Types<algo::LoserTree<int>,
+                                   algo::FibonacciMerger<int, std::less<int>>,
+                                   QuaternaryMerger<int, std::less<int>>>;
+    TYPED_TEST_SUITE(merger_test, Mergers);
+
+    void write_values(const std::filesystem::path& path, const std::vector<std::uint64_t>& values)
+    {
+        std::ofstream stream{path, std::ios::binary};
+        stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(std::uint64_t)));
+    }
+
+    std::vector<std::uint64_t> read_values(const std::filesystem::path& path)
+    {
+        std::vector<std::uint64_t> values(std::filesystem::file_size(path) / sizeof(std::uint64_t));
+        std::ifstream stream{path, std::ios::binary};
+        stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(std::uint64_t)));
+        return values;
+    }
+
+    using external_sort_test = algo::ScratchDirectoryTest;
+}
+
+TYPED_TEST(merger_test, merges_sorted_sources)
+{
+    std::mt19937 engine{1};
+    for(std::size_t sourceCount : {1, 3, 17})
+    {
+        std::vector<std::vector<int>> sources(sourceCount);
+        std::vector<int> expected;
+        for(auto& source : sources)
+        {
+            source.resize(engine() % 50);
+            for(auto& value : source)
+            {
+                value = static_cast<int>(engine() % 100);
+            }
+            std::sort(source.begin(), source.end());
+            expected.insert(expected.end(), source.begin(), source.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<std::size_t> positions(sourceCount, 0);
+        std::vector<std::optional<int>> initial(sourceCount);
+        for(std::size_t index{0}; index < sourceCount; ++index)
+        {
+            if(!sources[index].empty())
+            {
+                initial[index] = sources[index][positions[index]++];
+            }
+        }
+        TypeParam merger{initial};
+        std::vector<int> merged;
+        std::size_t lastSource{0};
+        while(!merger.empty())
+        {
+            if(!merged.empty()
+               && merged.back() == merger.top())
+            {
+                EXPECT_LE(lastSource, merger.top_source());
+            }
+            merged.push_back(merger.top());
+            lastSource = merger.top_source();
+            if(positions[lastSource] < sources[lastSource].size())
+            {
+                merger.replace_top(sources[lastSource][positions[lastSource]++]);
+            }
+            else
+            {
+                merger.pop();
+            }
+        }
+        EXPECT_EQ(merged, expected);
+    }
+}
+
+TEST_F(external_sort_test, sorts_in_several_passes)
+{
+    std::mt19937_64 engine{2};
+    std::vector<std::uint64_t> values(100'000);
+    for(auto& value : values)
+    {
+        value = engine() % 1'000'000;
+    }
+    write_values(directory / "input", values);
+    std::sort(values.begin(), values.end());
+    for(std::size_t threads : {1, 3})
+    {
+        const algo::ExternalSortOptions options{8192, 512, 4, threads, directory};
+        const auto stats{algo::external_sort<std::uint64_t>(directory / "input", directory / "output", options)};
+        EXPECT_EQ(read_values(directory / "output"), values);
+        EXPECT_GE(stats.runs, 100'000 * sizeof(std::uint64_t) / 8192);
+        EXPECT_GE(stats.mergePasses, 4u);
+        EXPECT_GT(stats.bytesWritten, 2 * values.size() * sizeof(std::uint64_t));
+    }
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator{directory}, std::filesystem::directory_iterator{}), 2);
+}
+
+TEST_F(external_sort_test, heap_merger_and_custom_order)
+{
+    std::mt19937_64 engine{3};
+    std::vector<std::uint64_t> values(20'000);
+    for(auto& value : values)
+    {
+        value = engine();
+    }
+    write_values(directory / "input", values);
+    std::sort(values.begin(), values.end(), std::greater<>{});
+    const algo::ExternalSortOptions options{16384, 1024, 0, 1, directory};
+    const auto stats{algo::external_sort<std::uint64_t, std::greater<std::uint64_t>, algo::FibonacciMerger>(directory / "input", directory / "output",
+                                                                                                           options, std::greater<std::uint64_t>{})};
+    EXPECT_EQ(read_values(directory / "output"), values);
+    EXPECT_EQ(stats.mergePasses, 1u);
+}
+
+TEST_F(external_sort_test, edge_cases)
+{
+    write_values(directory / "empty", {});
+    const algo::ExternalSortOptions options{4096, 512, 0, 1, directory};
+    const auto stats{algo::external_sort<std::uint64_t>(directory / "empty", directory / "output", options)};
+    EXPECT_EQ(stats.runs, 0u);
+    EXPECT_TRUE(read_values(directory / "output").empty());
+
+    std::ofstream{directory / "ragged", std::ios::binary} << "abc";
+    EXPECT_THROW(algo::external_sort<std::uint64_t>(directory / "ragged", directory / "output", options), std::invalid_argument);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
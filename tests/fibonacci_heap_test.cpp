@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../source/fibonacci_heap.h"
+
+TEST(fibonacci_heap_test, matches_multiset)
+{
+    std::mt19937 engine{37};
+    algo::fibonacci_heap<std::pair<int, int>> heap;
+    std::set<std::pair<int, int>> expected;
+    std::map<int, algo::fibonacci_heap<std::pair<int, int>>::handle> handles;
+    for(int step{0}; step < 50000; ++step)
+    {
+        switch(engine() % 5)
+        {
+        case 0:
+        case 1:
+            handles[step] = heap.push({static_cast<int>(engine() % 100000), step});
+            expected.emplace(handles[step]->key);
+            break;
+        case 2:
+            if(!expected.empty())
+            {
+                ASSERT_EQ(heap.top(), *expected.begin());
+                handles.erase(heap.top().second);
+                heap.pop();
+                expected.erase(expected.begin());
+            }
+            break;
+        case 3:
+            if(!handles.empty())
+            {
+                auto entry{handles.begin()};
+                std::advance(entry, engine() % handles.size());
+                auto key{entry->second->key};
+                expected.erase(key);
+                key.first -= static_cast<int>(engine() % 1000);
+                heap.decrease_key(entry->second, key);
+                expected.insert(key);
+            }
+            break;
+        default:
+            if(!handles.empty())
+            {
+                auto entry{handles.begin()};
+                std::advance(entry, engine() % handles.size());
+                expected.erase(entry->second->key);
+                heap.erase(entry->second);
+                handles.erase(entry);
+            }
+            break;
+        }
+        ASSERT_EQ(heap.size(), expected.size());
+    }
+    while(!heap.empty())
+    {
+        ASSERT_EQ(heap.top(), *expected.begin());
+        heap.pop();
+        expected.erase(expected.begin());
+    }
+    EXPECT_THROW(heap.pop(), std::out_of_range);
+}
+
+TEST(fibonacci_heap_test, merge_keeps_handles)
+{
+    algo::fibonacci_heap<int, std::greater<int>> left;
+    algo::fibonacci_heap<int, std::greater<int>> right;
+    for(int key{0}; key < 100; ++key)
+    {
+        left.push(key * 2);
+    }
+    std::vector<algo::fibonacci_heap<int, std::greater<int>>::handle> handles;
+    for(int key{0}; key < 100; ++key)
+    {
+        handles.push_back(right.push(key * 2 + 1));
+    }
+    left.pop();
+    left.merge(std::move(right));
+    EXPECT_TRUE(right.empty());
+    EXPECT_EQ(left.size(), 199);
+    EXPECT_EQ(left.top(), 199);
+    left.decrease_key(handles[3], 1000);
+    EXPECT_EQ(left.top(), 1000);
+    EXPECT_THROW(left.decrease_key(handles[4], 0), std::invalid_argument);
+    left.erase(handles[3]);
+    EXPECT_EQ(left.top(), 199);
+    std::vector<int> popped;
+    while(!left.empty())
+    {
+        popped.push_back(left.top());
+        left.pop();
+    }
+    EXPECT_TRUE(std::is_sorted(popped.rbegin(), popped.rend()));
+    EXPECT_EQ(popped.size(), 198);
+}
+
+// Each round pushes three keys below the current root, pops the smallest so the
+// other two and the old root consolidate under the middle key, then erases the
+// largest new key. The heap stays one tree that grows a level per round.
+TEST(fibonacci_heap_test, deep_heap_is_destroyed)
+{
+    constexpr int depth{300000};
+    algo::fibonacci_heap<int> heap;
+    for(int base{3 * depth}; base > 0; base -= 3)
+    {
+        heap.push(base - 3);
+        heap.push(base - 2);
+        auto largest{heap.push(base - 1)};
+        heap.pop();
+        heap.erase(largest);
+    }
+    EXPECT_EQ(heap.size(), depth);
+    EXPECT_EQ(heap.top(), 1);
+}
+
+TEST(fibonacci_heap_test, owns_non_trivial_keys)
+{
+    algo::fibonacci_heap<std::string> heap;
+    for(int round{0}; round < 3; ++round)
+    {
+        for(int key{0}; key < 500; ++key)
+        {
+            heap.push(std::string(40, static_cast<char>('a' + key % 26)) + std::to_string(key));
+        }
+        for(int key{0}; key < 200; ++key)
+        {
+            heap.pop();
+        }
+    }
+    heap.clear();
+    EXPECT_TRUE(heap.empty());
+    heap.emplace(3, 'x');
+    EXPECT_EQ(heap.top(), "xxx");
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include "../source/frozen_red_black_tree.h"
+
+TEST(frozen_red_black_tree_test, finds_every_size)
+{
+    for(int size{0}; size < 300; ++size)
+    {
+        algo::RedBlackTree<int, int> tree;
+        for(int key{0}; key < size; ++key)
+        {
+            tree.insert(key * 2, key);
+        }
+        auto frozen{algo::freeze(tree)};
+        ASSERT_EQ(frozen.size(), static_cast<std::size_t>(size));
+        for(int key{-1}; key <= size * 2; ++key)
+        {
+            const int* found{frozen.find(key)};
+            if(key >= 0 && key % 2 == 0 && key < size * 2)
+            {
+                ASSERT_NE(found, nullptr);
+                EXPECT_EQ(*found, key / 2);
+            }
+            else
+            {
+                EXPECT_EQ(found, nullptr);
+            }
+        }
+    }
+}
+
+TEST(frozen_red_black_tree_test, save_and_map)
+{
+    std::mt19937 engine{5};
+    algo::RedBlackTree<long, double> tree;
+    for(int step{0}; step < 5000; ++step)
+    {
+        long key{static_cast<long>(engine() % 100000)};
+        tree[key] = static_cast<double>(key) / 2;
+    }
+    const auto path{std::filesystem::temp_directory_path() / "frozen_red_black_tree_test.bin"};
+    algo::freeze(tree).save(path);
+    {
+        auto mapped{algo::FrozenRedBlackTree<long, double>::map(path)};
+        tree.for_each([&](long key, double value)
+        {
+            ASSERT_TRUE(mapped.contains(key));
+            EXPECT_EQ(*mapped.find(key), value);
+        });
+        EXPECT_THROW((algo::FrozenRedBlackTree<int, int>::map(path)), std::runtime_error);
+    }
+    std::filesystem::remove(path);
+}
+
+// The header stores count, keysOffset and valuesOffset at these byte offsets.
+TEST(frozen_red_black_tree_test, map_rejects_inconsistent_header)
+{
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 1000; ++key)
+    {
+        tree.insert(key, key);
+    }
+    const auto path{std::filesystem::temp_directory_path() / "frozen_red_black_tree_header_test.bin"};
+    for(const auto& [offset, value] : {std::pair<std::streamoff, std::uint64_t>{8, 2000}, {8, 1ull << 62}, {24, 0}, {32, 64}})
+    {
+        algo::freeze(tree).save(path);
+        {
+            std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        EXPECT_THROW((algo::FrozenRedBlackTree<int, int>::map(path)), std::runtime_error) << "offset " << offset;
+    }
+    std::filesystem::remove(path);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
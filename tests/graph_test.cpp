@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../source/fibonacci_heap.h"
+#include "../source/graph.h"
+#include "../source/pairing_heap.h"
+#include "../source/radix_heap.h"
+
+namespace
+{
+    using Graph = algo::CompressedGraph<std::uint64_t>;
+    using Edge = Graph::edge_type;
+
+    template<typename Key>
+    using FibonacciHeap = algo::fibonacci_heap<Key>;
+
+    template<typename Key>
+    using PairingHeap = algo::pairing_heap<Key>;
+
+    template<typename Key>
+    using BinaryHeap = algo::dary_heap<Key, std::less<Key>, 2>;
+
+    template<typename Key>
+    using RadixHeap = algo::radix_heap<Key>;
+
+    std::vector<Edge> random_edges(std::uint32_t vertices, std::size_t count, unsigned seed)
+    {
+        std::mt19937 engine{seed};
+        std::vector<Edge> edges;
+        for(std::size_t index{0}; index < count; ++index)
+        {
+            edges.push_back(Edge{static_cast<std::uint32_t>(engine() % vertices),
+                                 static_cast<std::uint32_t>(engine() % vertices),
+                                 engine() % 100});
+        }
+        return edges;
+    }
+
+    std::vector<std::uint64_t> bellman_ford(std::uint32_t vertices, const std::vector<Edge>& edges, std::uint32_t source)
+    {
+        constexpr std::uint64_t infinity{std::numeric_limits<std::uint64_t>::max()};
+        std::vector<std::uint64_t> distances(vertices, infinity);
+        distances[source] = 0;
+        for(std::uint32_t round{0}; round < vertices; ++round)
+        {
+            for(const auto& edge : edges)
+            {
+                if(distances[edge.source] != infinity
+                   && distances[edge.source] + edge.weight < distances[edge.target])
+                {
+                    distances[edge.target] = distances[edge.source] + edge.weight;
+                }
+            }
+        }
+        return distances;
+    }
+
+    std::uint32_t find_root(std::vector<std::uint32_t>& roots, std::uint32_t vertex)
+    {
+        while(roots[vertex] != vertex)
+        {
+            vertex = roots[vertex] = roots[roots[vertex]];
+        }
+        return vertex;
+    }
+
+    template<typename Search>
+    class graph_search_test : public testing::Test
+    {
+    };
+
+    template<template<typename> class Heap>
+    using SearchWith = algo::GraphSearch<std::uint64_t, Heap>;
+
+    using Searches = testing::Types<SearchWith<FibonacciHeap>,
+                                    SearchWith<PairingHeap>,
+                                    SearchWith<algo::QuaternaryHeap>,
+                                    SearchWith<BinaryHeap>,
+                                    SearchWith<RadixHeap>>;
+}
+
+TYPED_TEST_SUITE(graph_search_test, Searches);
+
+TYPED_TEST(graph_search_test, dijkstra_matches_bellman_ford)
+{
+    constexpr std::uint32_t vertices{300};
+    const auto edges{random_edges(vertices, 1500, 3)};
+    const Graph graph{vertices, edges};
+    TypeParam search{graph};
+    for(std::uint32_t source : {0u, 17u, 299u})
+    {
+        search.dijkstra(source);
+        const auto expected{bellman_ford(vertices, edges, source)};
+        for(std::uint32_t vertex{0}; vertex < vertices; ++vertex)
+        {
+            ASSERT_EQ(search.distance(vertex), expected[vertex]);
+            if(search.reached(vertex)
+               && vertex != source)
+            {
+                const auto path{search.path(vertex)};
+                ASSERT_EQ(path.front(), source);
+                ASSERT_EQ(path.back(), vertex);
+            }
+        }
+    }
+    search.dijkstra(5, 6);
+    EXPECT_EQ(search.distance(6), bellman_ford(vertices, edges, 5)[6]);
+    EXPECT_LE(search.settled_count(), vertices);
+    EXPECT_THROW(search.dijkstra(vertices), std::out_of_range);
+}
+
+TYPED_TEST(graph_search_test, a_star_on_grid_matches_dijkstra)
+{
+    constexpr std::uint32_t side{40};
+    std::mt19937 engine{11};
+    std::vector<Edge> edges;
+    for(std::uint32_t row{0}; row < side; ++row)
+    {
+        for(std::uint32_t column{0}; column < side; ++column)
+        {
+            std::uint32_t vertex{row * side + column};
+            if(column + 1 < side)
+            {
+                edges.push_back(Edge{vertex, vertex + 1, 1 + engine() % 9});
+            }
+            if(row + 1 < side)
+            {
+                edges.push_back(Edge{vertex, vertex + side, 1 + engine() % 9});
+            }
+        }
+    }
+    const Graph graph{side * side, edges, algo::GraphKind::undirected};
+    TypeParam search{graph};
+    const std::uint32_t target{side * side - 1};
+    search.dijkstra(0, target);
+    const auto expected{search.distance(target)};
+    const auto dijkstraSettled{search.settled_count()};
+    search.a_star(0, target, [&](std::uint32_t vertex)
+    {
+        return std::uint64_t{(side - 1 - vertex / side) + (side - 1 - vertex % side)};
+    });
+    EXPECT_EQ(search.distance(target), expected);
+    EXPECT_LE(search.settled_count(), dijkstraSettled);
+}
+
+TEST(graph_search_test, prim_matches_kruskal)
+{
+    constexpr std::uint32_t vertices{500};
+    auto edges{random_edges(vertices, 4000, 5)};
+    for(std::uint32_t vertex{1}; vertex < vertices; ++vertex)
+    {
+        edges.push_back(Edge{vertex - 1, vertex, 1000});
+    }
+    const Graph graph{vertices, edges, algo::GraphKind::undirected};
+    algo::GraphSearch<std::uint64_t> search{graph};
+    const auto total{search.prim(0)};
+
+    std::sort(edges.begin(), edges.end(), [](const Edge& left, const Edge& right)
+    {
+        return left.weight < right.weight;
+    });
+    std::vector<std::uint32_t> roots(vertices);
+    std::iota(roots.begin(), roots.end(), 0u);
+    std::uint64_t expected{0};
+    for(const auto& edge : edges)
+    {
+        auto source{find_root(roots, edge.source)};
+        auto target{find_root(roots, edge.target)};
+        if(source != target)
+        {
+            roots[source] = target;
+            expected += edge.weight;
+        }
+    }
+    EXPECT_EQ(total, expected);
+    EXPECT_EQ(search.settled_count(), vertices);
+}
+
+TEST(compressed_graph_test, groups_arcs_by_source)
+{
+    const std::vector<Edge> edges{{2, 0, 7}, {0, 1, 3}, {2, 1, 4}, {0, 2, 5}};
+    const Graph graph{3, edges};
+    EXPECT_EQ(graph.vertex_count(), 3u);
+    EXPECT_EQ(graph.arc_count(), 4u);
+    ASSERT_EQ(graph.degree(0), 2u);
+    EXPECT_EQ(graph.arcs_of(0)[0].target, 1u);
+    EXPECT_EQ(graph.arcs_of(0)[1].target, 2u);
+    EXPECT_EQ(graph.degree(1), 0u);
+    EXPECT_EQ(graph.arcs_of(2)[1].weight, 4u);
+    EXPECT_THROW((Graph{2, edges}), std::out_of_range);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "../source/indexed_red_black_tree.h"
+
+TEST(indexed_red_black_tree_test, node_is_compact)
+{
+    EXPECT_EQ(sizeof(algo::IndexedRedBlackNode<int, int>), 16);
+}
+
+TEST(indexed_red_black_tree_test, matches_map)
+{
+    std::mt19937 engine{11};
+    algo::IndexedRedBlackTree<int, int> tree;
+    std::map<int, int> expected;
+    for(int step{0}; step < 20000; ++step)
+    {
+        int key{static_cast<int>(engine() % 1000)};
+        switch(engine() % 3)
+        {
+        case 0:
+            tree.remove(key);
+            expected.erase(key);
+            break;
+        case 1:
+            tree[key] = step;
+            expected[key] = step;
+            break;
+        default:
+            tree.insert(key, step);
+            expected.emplace(key, step);
+            break;
+        }
+    }
+    ASSERT_EQ(tree.size(), expected.size());
+    std::map<int, int> contents;
+    tree.for_each([&](int key, int value)
+    {
+        contents.emplace(key, value);
+    });
+    EXPECT_EQ(contents, expected);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../source/interval_tree.h"
+
+namespace
+{
+    using Tree = algo::IntervalTree<int, int>;
+
+    std::vector<std::pair<int, int>> collect(Tree::OverlapRange range)
+    {
+        std::vector<std::pair<int, int>> found;
+        for(const auto& node : range)
+        {
+            found.emplace_back(node.key.low, node.key.high);
+        }
+        return found;
+    }
+
+    std::vector<std::pair<int, int>> brute_force(const std::multiset<std::pair<int, int>>& intervals, int low, int high)
+    {
+        std::vector<std::pair<int, int>> found;
+        for(const auto& interval : intervals)
+        {
+            if(interval.first <= high && low <= interval.second)
+            {
+                found.push_back(interval);
+            }
+        }
+        return found;
+    }
+}
+
+TEST(interval_tree_test, matches_brute_force)
+{
+    std::mt19937 engine{29};
+    Tree tree;
+    std::multiset<std::pair<int, int>> expected;
+    for(int step{0}; step < 20000; ++step)
+    {
+        int low{static_cast<int>(engine() % 10000)};
+        int high{low + static_cast<int>(engine() % 300)};
+        if(engine() % 3 == 0 && !expected.empty())
+        {
+            auto victim{*std::next(expected.begin(), static_cast<long>(engine() % expected.size()))};
+            tree.remove({victim.first, victim.second});
+            expected.erase(expected.find(victim));
+        }
+        else
+        {
+            tree.insert({low, high}, step);
+            expected.emplace(low, high);
+        }
+        if(step % 100 == 0)
+        {
+            int queryLow{static_cast<int>(engine() % 10000)};
+            int queryHigh{queryLow + static_cast<int>(engine() % 50)};
+            ASSERT_EQ(collect(tree.overlapping(queryLow, queryHigh)), brute_force(expected, queryLow, queryHigh));
+            ASSERT_EQ(collect(tree.stabbing(queryLow)), brute_force(expected, queryLow, queryLow));
+        }
+    }
+}
+
+TEST(interval_tree_test, survives_split_and_join)
+{
+    Tree tree;
+    std::multiset<std::pair<int, int>> expected;
+    for(int low{0}; low < 2000; ++low)
+    {
+        int high{low + (low * 7919) % 500};
+        tree.insert({low, high}, low);
+        expected.emplace(low, high);
+    }
+    auto upper{tree.split({1000, 0})};
+    EXPECT_EQ(collect(tree.overlapping(1200, 1300)), (brute_force(std::multiset<std::pair<int, int>>{expected.begin(), expected.lower_bound({1000, 0})}, 1200, 1300)));
+    tree.join2(std::move(upper));
+    EXPECT_EQ(collect(tree.overlapping(1200, 1300)), brute_force(expected, 1200, 1300));
+    Tree copy{tree};
+    EXPECT_EQ(collect(copy.stabbing(1500)), brute_force(expected, 1500, 1500));
+}
+
+TEST(interval_tree_test, streams_lazily)
+{
+    Tree tree;
+    for(int low{0}; low < 1000; ++low)
+    {
+        tree.insert({low, low + 10}, low);
+    }
+    auto results{tree.overlapping(100, 900)};
+    auto first{results.begin()};
+    EXPECT_EQ(first->key.low, 90);
+    EXPECT_EQ((++first)->key.low, 91);
+    EXPECT_THROW(tree.overlapping(5, 1), std::invalid_argument);
+    EXPECT_THROW(tree.insert({5, 1}, 0), std::invalid_argument);
+}
+
+TEST(interval_tree_test, keeps_duplicates)
+{
+    Tree tree;
+    tree.insert({1, 5}, 10);
+    tree.insert({1, 5}, 20);
+    tree.insert({2, 3}, 30);
+    EXPECT_EQ(collect(tree.stabbing(3)), (std::vector<std::pair<int, int>>{{1, 5}, {1, 5}, {2, 3}}));
+    EXPECT_EQ(tree.find({1, 5})->data, 10);
+    tree.remove({1, 5});
+    EXPECT_EQ(tree.find({1, 5})->data, 20);
+    tree.remove({1, 5});
+    EXPECT_FALSE(tree.contains({1, 5}));
+    EXPECT_EQ(collect(tree.stabbing(3)), (std::vector<std::pair<int, int>>{{2, 3}}));
+    tree.validate();
+}
+
+// Only the checked surface is public, so nothing can store an interval with low > high.
+template<typename IntervalMap>
+concept exposes_unchecked_insertion = requires(IntervalMap tree, IntervalMap other, algo::SequencedInterval<int> key)
+{
+    tree.try_emplace(key, 0);
+} || requires(IntervalMap tree, algo::SequencedInterval<int> key)
+{
+    tree[key];
+} || requires(IntervalMap tree, IntervalMap other)
+{
+    tree.merge(other);
+} || requires(IntervalMap tree, IntervalMap other)
+{
+    tree.set_union(std::move(other));
+};
+
+static_assert(!exposes_unchecked_insertion<Tree>);
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "../source/dynamic_matrix.h"
+#include "../source/matrix_decomposition.h"
+#include "../source/matrix_multiply.h"
+
+namespace
+{
+    using Matrix = algo::DynamicMatrix<double>;
+
+    Matrix transposed(const Matrix& matrix)
+    {
+        Matrix result{matrix.cols(), matrix.rows()};
+        for(std::size_t row{0}; row < matrix.rows(); ++row)
+        {
+            for(std::size_t col{0}; col < matrix.cols(); ++col)
+            {
+                result[col, row] = matrix[row, col];
+            }
+        }
+        return result;
+    }
+
+    double distance(const Matrix& lhs, const Matrix& rhs)
+    {
+        double sum{0};
+        for(std::size_t index{0}; index < lhs.size(); ++index)
+        {
+            sum += (lhs.data()[index] - rhs.data()[index]) * (lhs.data()[index] - rhs.data()[index]);
+        }
+        return std::sqrt(sum);
+    }
+
+    void expect_orthonormal_columns(const Matrix& matrix, double tolerance)
+    {
+        Matrix gram{matrix.cols(), matrix.cols()};
+        algo::multiply_transposed_into(algo::matrix_view(matrix), algo::matrix_view(matrix), algo::matrix_view(gram));
+        for(std::size_t row{0}; row < gram.rows(); ++row)
+        {
+            for(std::size_t col{0}; col < gram.cols(); ++col)
+            {
+                EXPECT_NEAR((gram[row, col]), row == col? 1.0 : 0.0, tolerance);
+            }
+        }
+    }
+
+    // U diag(values) V^T with random orthonormal U and V.
+    Matrix with_spectrum(std::size_t rows, std::size_t cols, const std::vector<double>& values, std::uint64_t seed)
+    {
+        const auto left{algo::thin_qr(algo::gaussian_matrix<double>(rows, values.size(), seed)).q};
+        const auto right{algo::thin_qr(algo::gaussian_matrix<double>(cols, values.size(), seed + 1)).q};
+        Matrix scaled{left};
+        for(std::size_t row{0}; row < rows; ++row)
+        {
+            for(std::size_t col{0}; col < values.size(); ++col)
+            {
+                scaled[row, col] *= values[col];
+            }
+        }
+        return algo::multiply(scaled, transposed(right));
+    }
+}
+
+TEST(matrix_decomposition_test, blocked_qr_reconstructs)
+{
+    for(std::size_t blockSize : {1, 7, 32})
+    {
+        const auto matrix{algo::gaussian_matrix<double>(203, 70, 1)};
+        const auto [q, r]{algo::thin_qr(matrix, blockSize)};
+        expect_orthonormal_columns(q, 1e-12);
+        for(std::size_t row{0}; row < r.rows(); ++row)
+        {
+            for(std::size_t col{0}; col < row; ++col)
+            {
+                EXPECT_EQ((r[row, col]), 0.0);
+            }
+        }
+        EXPECT_LT(distance(algo::multiply(q, r), matrix), 1e-11);
+    }
+}
+
+TEST(matrix_decomposition_test, qr_of_rank_deficient_matrix_stays_orthonormal)
+{
+    Matrix matrix{50, 6};
+    for(std::size_t row{0}; row < 50; ++row)
+    {
+        matrix[row, 0] = static_cast<double>(row);
+        matrix[row, 2] = 2.0 * static_cast<double>(row);
+        matrix[row, 4] = 1.0;
+    }
+    const auto [q, r]{algo::thin_qr(matrix, 4)};
+    expect_orthonormal_columns(q, 1e-12);
+    EXPECT_LT(distance(algo::multiply(q, r), matrix), 1e-11);
+    EXPECT_THROW(algo::thin_qr(Matrix{3, 4}), std::invalid_argument);
+}
+
+TEST(matrix_decomposition_test, small_solvers)
+{
+    const Matrix matrix{with_spectrum(9, 6, {5, 4, 3, 2, 1, 0.5}, 2)};
+    const auto svd{algo::jacobi_svd(matrix)};
+    EXPECT_NEAR(svd.singularValues[0], 5, 1e-12);
+    EXPECT_NEAR(svd.singularValues[5], 0.5, 1e-12);
+    expect_orthonormal_columns(svd.u, 1e-12);
+    expect_orthonormal_columns(svd.v, 1e-12);
+
+    const Matrix symmetric{algo::multiply(transposed(matrix), matrix)};
+    const auto eigen{algo::jacobi_eigen(symmetric)};
+    EXPECT_NEAR(eigen.eigenvalues[0], 25, 1e-10);
+    EXPECT_NEAR(eigen.eigenvalues[5], 0.25, 1e-10);
+    expect_orthonormal_columns(eigen.vectors, 1e-12);
+}
+
+TEST(matrix_decomposition_test, randomized_svd_recovers_top_singular_triplets)
+{
+    std::vector<double> values;
+    for(std::size_t index{0}; index < 60; ++index)
+    {
+        values.push_back(index < 8? 100.0 - 10.0 * static_cast<double>(index) : std::pow(0.7, static_cast<double>(index)));
+    }
+    const Matrix matrix{with_spectrum(600, 150, values, 3)};
+    const auto svd{algo::randomized_svd(matrix, 8)};
+    ASSERT_EQ(svd.singularValues.size(), 8u);
+    for(std::size_t index{0}; index < 8; ++index)
+    {
+        EXPECT_NEAR(svd.singularValues[index], values[index], 1e-8 * values[index]);
+    }
+    expect_orthonormal_columns(svd.u, 1e-10);
+    expect_orthonormal_columns(svd.v, 1e-10);
+
+    Matrix scaled{svd.u};
+    for(std::size_t row{0}; row < scaled.rows(); ++row)
+    {
+        for(std::size_t col{0}; col < scaled.cols(); ++col)
+        {
+            scaled[row, col] *= svd.singularValues[col];
+        }
+    }
+    double tail{0};
+    for(std::size_t index{8}; index < values.size(); ++index)
+    {
+        tail += values[index] * values[index];
+    }
+    EXPECT_LT(distance(algo::multiply(scaled, transposed(svd.v)), matrix), 1.01 * std::sqrt(tail));
+
+    const auto again{algo::randomized_svd(matrix, 8)};
+    EXPECT_EQ(again.singularValues, svd.singularValues);
+    EXPECT_EQ(distance(again.u, svd.u), 0.0);
+    EXPECT_THROW(algo::randomized_svd(matrix, 151), std::invalid_argument);
+}
+
+TEST(matrix_decomposition_test, lanczos_finds_largest_eigenpairs)
+{
+    std::vector<double> values{50, 40, 30, 20, 10};
+    for(std::size_t index{0}; index < 195; ++index)
+    {
+        values.push_back(static_cast<double>(index % 7) * 0.1 - 0.3);
+    }
+    const auto basis{algo::thin_qr(algo::gaussian_matrix<double>(200, 200, 4)).q};
+    Matrix scaled{basis};
+    for(std::size_t row{0}; row < 200; ++row)
+    {
+        for(std::size_t col{0}; col < 200; ++col)
+        {
+            scaled[row, col] *= values[col];
+        }
+    }
+    const Matrix matrix{algo::multiply(scaled, transposed(basis))};
+    const auto eigen{algo::lanczos_eigen(matrix, 5, algo::LanczosOptions{4, 40, 7})};
+    for(std::size_t index{0}; index < 5; ++index)
+    {
+        EXPECT_NEAR(eigen.eigenvalues[index], values[index], 1e-8);
+    }
+    expect_orthonormal_columns(eigen.vectors, 1e-10);
+    const Matrix image{algo::multiply(matrix, eigen.vectors)};
+    for(std::size_t row{0}; row < 200; ++row)
+    {
+        for(std::size_t col{0}; col < 5; ++col)
+        {
+            EXPECT_NEAR((image[row, col]), (eigen.eigenvalues[col] * eigen.vectors[row, col]), 1e-6);
+        }
+    }
+    EXPECT_THROW(algo::lanczos_eigen(Matrix{3, 4}, 1), std::invalid_argument);
+
+    // The Krylov space of the identity stops growing after one block.
+    Matrix identity{30};
+    for(std::size_t index{0}; index < 30; ++index)
+    {
+        identity[index, index] = 1.0;
+    }
+    const auto flat{algo::lanczos_eigen(identity, 6, algo::LanczosOptions{4, 12, 7})};
+    EXPECT_NEAR(flat.eigenvalues[5], 1.0, 1e-12);
+    expect_orthonormal_columns(flat.vectors, 1e-12);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
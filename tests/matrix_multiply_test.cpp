@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include "../source/counting_memory_resource.h"
+#include "../source/dynamic_matrix.h"
+#include "../source/matrix_multiply.h"
+
+namespace
+{
+    // Small integer entries keep every product exact, so results can be compared for equality.
+    template<typename Type, typename Allocator = std::allocator<Type>>
+    algo::DynamicMatrix<Type, Allocator> random_matrix(std::size_t rows, std::size_t cols, unsigned seed, const Allocator& memory = Allocator{})
+    {
+        std::mt19937 engine{seed};
+        std::uniform_int_distribution<int> value{-9, 9};
+        algo::DynamicMatrix<Type, Allocator> matrix{rows, cols, memory};
+        for(auto& element : matrix)
+        {
+            element = static_cast<Type>(value(engine));
+        }
+        return matrix;
+    }
+
+    template<typename Type>
+    algo::DynamicMatrix<Type> naive_product(const algo::DynamicMatrix<Type>& lhs, const algo::DynamicMatrix<Type>& rhs)
+    {
+        algo::DynamicMatrix<Type> product{lhs.rows(), rhs.cols()};
+        for(std::size_t row{0}; row < lhs.rows(); ++row)
+        {
+            for(std::size_t col{0}; col < rhs.cols(); ++col)
+            {
+                Type sum{0};
+                for(std::size_t inner{0}; inner < lhs.cols(); ++inner)
+                {
+                    sum += lhs[row, inner] * rhs[inner, col];
+                }
+                product[row, col] = sum;
+            }
+        }
+        return product;
+    }
+
+    template<typename Matrix>
+    void expect_equal(const Matrix& expected, const Matrix& actual)
+    {
+        ASSERT_EQ(expected.rows(), actual.rows());
+        ASSERT_EQ(expected.cols(), actual.cols());
+        for(std::size_t row{0}; row < expected.rows(); ++row)
+        {
+            for(std::size_t col{0}; col < expected.cols(); ++col)
+            {
+                ASSERT_EQ((expected[row, col]), (actual[row, col])) << "at " << row << ", " << col;
+            }
+        }
+    }
+}
+
+TEST(matrix_multiply_test, classical_matches_naive)
+{
+    for(auto [rows, inner, cols] : {std::tuple{1, 1, 1}, {3, 0, 4}, {17, 300, 5}, {130, 129, 700}})
+    {
+        const auto lhs{random_matrix<std::int64_t>(rows, inner, 1)};
+        const auto rhs{random_matrix<std::int64_t>(inner, cols, 2)};
+        expect_equal(naive_product(lhs, rhs), algo::multiply(lhs, rhs));
+    }
+}
+
+TEST(matrix_multiply_test, strassen_matches_classical_on_odd_shapes)
+{
+    for(std::size_t parallelDepth : {0, 1, 2})
+    {
+        const algo::StrassenOptions options{8, parallelDepth};
+        for(auto [rows, inner, cols] : {std::tuple{2, 2, 2}, {9, 9, 9}, {64, 64, 64}, {37, 53, 71}, {100, 17, 129}, {127, 255, 66}})
+        {
+            const auto lhs{random_matrix<std::int64_t>(rows, inner, 3)};
+            const auto rhs{random_matrix<std::int64_t>(inner, cols, 4)};
+            expect_equal(algo::multiply(lhs, rhs), algo::strassen_multiply(lhs, rhs, options));
+        }
+    }
+}
+
+TEST(matrix_multiply_test, strassen_on_doubles_stays_close)
+{
+    std::mt19937 engine{5};
+    std::uniform_real_distribution<double> value{-1.0, 1.0};
+    algo::DynamicMatrix<double> lhs{300, 300};
+    algo::DynamicMatrix<double> rhs{300, 300};
+    for(auto& element : lhs)
+    {
+        element = value(engine);
+    }
+    for(auto& element : rhs)
+    {
+        element = value(engine);
+    }
+    const auto expected{algo::multiply(lhs, rhs)};
+    const auto actual{algo::strassen_multiply(lhs, rhs, algo::StrassenOptions{16, 1})};
+    for(std::size_t index{0}; index < expected.size(); ++index)
+    {
+        EXPECT_NEAR(expected.data()[index], actual.data()[index], 1e-10);
+    }
+}
+
+TEST(matrix_multiply_test, strassen_allocates_workspace_once)
+{
+    algo::CountingMemoryResource resource;
+    const auto lhs{random_matrix<std::int64_t>(96, 80, 6, std::pmr::polymorphic_allocator<std::int64_t>{&resource})};
+    const auto rhs{random_matrix<std::int64_t>(80, 72, 7, std::pmr::polymorphic_allocator<std::int64_t>{&resource})};
+    resource.reset_stats();
+    const auto product{algo::strassen_multiply(lhs, rhs, algo::StrassenOptions{4, 1})};
+    EXPECT_EQ(product.get_allocator().resource(), &resource);
+    EXPECT_EQ(resource.stats().allocations, 2u);
+    const algo::StrassenMultiplier<std::int64_t> multiplier{algo::StrassenOptions{4, 1}};
+    EXPECT_EQ(resource.stats().bytesAllocated, (96 * 72 + multiplier.workspace_size(96, 80, 72)) * sizeof(std::int64_t));
+}
+
+TEST(matrix_multiply_test, mismatched_shapes_throw)
+{
+    const algo::DynamicMatrix<double> lhs{3, 4};
+    const algo::DynamicMatrix<double> rhs{3, 4};
+    EXPECT_THROW(algo::multiply(lhs, rhs), std::invalid_argument);
+    EXPECT_THROW(algo::strassen_multiply(lhs, rhs), std::invalid_argument);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
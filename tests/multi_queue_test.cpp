@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../source/graph.h"
+#include "../source/multi_queue.h"
+#include "../source/parallel_graph_search.h"
+
+TEST(multi_queue_test, returns_every_key_once)
+{
+    algo::MultiQueue<int> queue{8};
+    std::vector<int> keys(10000);
+    for(int index{0}; index < static_cast<int>(keys.size()); ++index)
+    {
+        keys[index] = index;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{3});
+    for(int key : keys)
+    {
+        queue.push(key);
+    }
+    EXPECT_EQ(queue.size(), keys.size());
+    std::vector<int> popped;
+    while(auto key{queue.try_pop()})
+    {
+        popped.push_back(*key);
+    }
+    EXPECT_TRUE(queue.empty());
+    std::sort(popped.begin(), popped.end());
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(popped, keys);
+    EXPECT_THROW(algo::MultiQueue<int>{0}, std::invalid_argument);
+}
+
+TEST(multi_queue_test, single_lane_is_exact)
+{
+    algo::MultiQueue<int, std::greater<int>> queue{1};
+    for(int key : {4, 9, 1, 7})
+    {
+        queue.push(key);
+    }
+    EXPECT_EQ(queue.try_pop(), 9);
+    EXPECT_EQ(queue.try_pop(), 7);
+    EXPECT_EQ(queue.try_pop(), 4);
+    EXPECT_EQ(queue.try_pop(), 1);
+    EXPECT_FALSE(queue.try_pop());
+}
+
+TEST(multi_queue_test, concurrent_push_and_pop)
+{
+    constexpr int threads{4};
+    constexpr int perThread{20000};
+    algo::MultiQueue<int> queue{threads * 2};
+    std::vector<std::vector<int>> popped(threads);
+    {
+        std::vector<std::jthread> workers;
+        for(int thread{0}; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread]
+            {
+                for(int index{0}; index < perThread; ++index)
+                {
+                    queue.push(thread * perThread + index);
+                    if(index % 2)
+                    {
+                        if(auto key{queue.try_pop()})
+                        {
+                            popped[thread].push_back(*key);
+                        }
+                    }
+                }
+            });
+        }
+    }
+    std::vector<int> all;
+    for(const auto& part : popped)
+    {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    while(auto key{queue.try_pop()})
+    {
+        all.push_back(*key);
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<std::size_t>(threads * perThread));
+    for(int index{0}; index < threads * perThread; ++index)
+    {
+        ASSERT_EQ(all[index], index);
+    }
+}
+
+TEST(parallel_graph_search_test, matches_sequential_dijkstra)
+{
+    using Graph = algo::CompressedGraph<std::uint64_t>;
+    constexpr std::uint32_t vertices{2000};
+    std::mt19937 engine{9};
+    std::vector<Graph::edge_type> edges;
+    for(int index{0}; index < 12000; ++index)
+    {
+        edges.push_back({static_cast<std::uint32_t>(engine() % vertices),
+                         static_cast<std::uint32_t>(engine() % vertices),
+                         engine() % 1000});
+    }
+    const Graph graph{vertices, edges};
+    algo::GraphSearch<std::uint64_t> sequential{graph};
+    algo::ParallelGraphSearch<std::uint64_t> parallel{graph, 4};
+    for(std::uint32_t source : {0u, 1234u})
+    {
+        sequential.dijkstra(source);
+        const auto work{parallel.dijkstra(source)};
+        EXPECT_EQ(work.reached, sequential.settled_count());
+        EXPECT_GE(work.expanded, work.reached);
+        for(std::uint32_t vertex{0}; vertex < vertices; ++vertex)
+        {
+            ASSERT_EQ(parallel.distance(vertex), sequential.distance(vertex));
+        }
+    }
+    EXPECT_THROW(parallel.dijkstra(vertices), std::out_of_range);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include "../source/dynamic_matrix.h"
+#include "../source/matrix_multiply.h"
+#include "../source/out_of_core_multiply.h"
+#include "scratch_directory_fixture.h"
+
+namespace
+{
+    using Matrix = algo::DynamicMatrix<std::int64_t>;
+
+    Matrix random_matrix(std::size_t rows, std::size_t cols, unsigned seed)
+    {
+        std::mt19937 engine{seed};
+        std::uniform_int_distribution<int> value{-9, 9};
+        Matrix matrix{rows, cols};
+        for(auto& element : matrix)
+        {
+            element = value(engine);
+        }
+        return matrix;
+    }
+
+    void expect_equal(const Matrix& expected, const Matrix& actual)
+    {
+        ASSERT_EQ(expected.rows(), actual.rows());
+        ASSERT_EQ(expected.cols(), actual.cols());
+        for(std::size_t index{0}; index < expected.size(); ++index)
+        {
+            ASSERT_EQ(expected.data()[index], actual.data()[index]) << "at " << index;
+        }
+    }
+
+    using out_of_core_multiply_test = algo::ScratchDirectoryTest;
+}
+
+TEST_F(out_of_core_multiply_test, tiled_file_round_trip)
+{
+    const Matrix matrix{random_matrix(37, 23, 1)};
+    algo::write_tiled_matrix(directory / "matrix", matrix, 8);
+    algo::TiledMatrixFile<std::int64_t> file{directory / "matrix"};
+    EXPECT_EQ(file.tile_rows(), 5u);
+    EXPECT_EQ(file.tile_cols(), 3u);
+    EXPECT_EQ(std::filesystem::file_size(directory / "matrix"), 24 + 15 * 64 * sizeof(std::int64_t));
+    expect_equal(matrix, algo::read_tiled_matrix<std::int64_t>(directory / "matrix"));
+    std::int64_t tile[64];
+    EXPECT_THROW(file.read_tiles(0, 2, 2, tile), std::out_of_range);
+}
+
+TEST_F(out_of_core_multiply_test, matches_in_memory_product_for_any_budget)
+{
+    const Matrix lhs{random_matrix(45, 37, 2)};
+    const Matrix rhs{random_matrix(37, 61, 3)};
+    algo::write_tiled_matrix(directory / "lhs", lhs, 8);
+    algo::write_tiled_matrix(directory / "rhs", rhs, 8);
+    const Matrix expected{algo::multiply(lhs, rhs)};
+    constexpr std::size_t tileBytes{64 * sizeof(std::int64_t)};
+    for(std::size_t tiles : {5, 11, 1000})
+    {
+        const auto stats{algo::out_of_core_multiply<std::int64_t>(directory / "lhs", directory / "rhs", directory / "product",
+                                                                  algo::OutOfCoreOptions{tiles * tileBytes})};
+        expect_equal(expected, algo::read_tiled_matrix<std::int64_t>(directory / "product"));
+        EXPECT_LE(stats.residentBytes, tiles * tileBytes);
+        EXPECT_EQ(stats.bytesWritten, 6 * 8 * tileBytes);
+        EXPECT_GT(stats.bytesRead, 0u);
+        EXPECT_GT(stats.flops, 0.0);
+        EXPECT_GE(stats.overlap(), 0.0);
+    }
+}
+
+TEST_F(out_of_core_multiply_test, rejects_bad_operands)
+{
+    algo::write_tiled_matrix(directory / "lhs", random_matrix(8, 8, 4), 4);
+    algo::write_tiled_matrix(directory / "rhs", random_matrix(9, 8, 5), 4);
+    algo::write_tiled_matrix(directory / "other", random_matrix(8, 8, 6), 2);
+    EXPECT_THROW(algo::out_of_core_multiply<std::int64_t>(directory / "lhs", directory / "rhs", directory / "product"), std::invalid_argument);
+    EXPECT_THROW(algo::out_of_core_multiply<std::int64_t>(directory / "lhs", directory / "other", directory / "product"), std::invalid_argument);
+    EXPECT_THROW(algo::out_of_core_multiply<std::int64_t>(directory / "lhs", directory / "lhs", directory / "product", algo::OutOfCoreOptions{64}),
+                 std::invalid_argument);
+    EXPECT_THROW(algo::TiledMatrixFile<std::int64_t>{directory / "missing"}, std::runtime_error);
+}
+
+TEST(scratch_directory_test, names_are_never_shared)
+{
+    std::filesystem::path first;
+    std::filesystem::path second;
+    {
+        const algo::ScratchDirectory one{std::filesystem::temp_directory_path(), "scratch_directory_test_"};
+        const algo::ScratchDirectory two{std::filesystem::temp_directory_path(), "scratch_directory_test_"};
+        first = one.path();
+        second = two.path();
+        EXPECT_NE(first, second);
+        EXPECT_TRUE(std::filesystem::is_directory(first));
+        EXPECT_TRUE(std::filesystem::is_empty(second));
+    }
+    EXPECT_FALSE(std::filesystem::exists(first));
+    EXPECT_FALSE(std::filesystem::exists(second));
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
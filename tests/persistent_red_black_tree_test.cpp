@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../source/persistent_red_black_tree.h"
+
+namespace
+{
+    std::map<int, int> contents(const algo::PersistentRedBlackTree<int, int>& tree)
+    {
+        std::map<int, int> result;
+        tree.for_each([&](int key, int value)
+        {
+            result.emplace(key, value);
+        });
+        return result;
+    }
+}
+
+TEST(persistent_red_black_tree_test, snapshot_is_isolated)
+{
+    algo::PersistentRedBlackTree<int, int> tree;
+    for(int key{0}; key < 100; ++key)
+    {
+        tree.insert(key, key);
+    }
+    auto snapshot{tree.snapshot()};
+    tree.remove(10);
+    tree[20] = -20;
+    tree.insert(200, 200);
+    EXPECT_EQ(tree.find(10), nullptr);
+    EXPECT_EQ(tree.find(20)->data, -20);
+    EXPECT_NE(snapshot.find(10), nullptr);
+    EXPECT_EQ(snapshot.find(20)->data, 20);
+    EXPECT_EQ(snapshot.find(200), nullptr);
+}
+
+TEST(persistent_red_black_tree_test, random_versions)
+{
+    std::mt19937 engine{7};
+    algo::PersistentRedBlackTree<int, int> tree;
+    std::map<int, int> expected;
+    std::vector<std::pair<algo::PersistentRedBlackTree<int, int>, std::map<int, int>>> versions;
+    for(int step{0}; step < 5000; ++step)
+    {
+        int key{static_cast<int>(engine() % 300)};
+        switch(engine() % 4)
+        {
+        case 0:
+            tree.remove(key);
+            expected.erase(key);
+            break;
+        case 1:
+            tree[key] = step;
+            expected[key] = step;
+            break;
+        default:
+            tree.insert(key, step);
+            expected.emplace(key, step);
+            break;
+        }
+        if(step % 500 == 0)
+        {
+            versions.emplace_back(tree.snapshot(), expected);
+        }
+    }
+    EXPECT_EQ(contents(tree), expected);
+    for(const auto& [version, state] : versions)
+    {
+        EXPECT_EQ(contents(version), state);
+    }
+}
+
+TEST(persistent_red_black_tree_test, export_snapshot_concurrently)
+{
+    algo::PersistentRedBlackTree<int, int> tree;
+    for(int key{0}; key < 10000; ++key)
+    {
+        tree.insert(key, key);
+    }
+    auto snapshot{tree.snapshot()};
+    std::map<int, int> exported;
+    std::thread exporter{[&]
+    {
+        exported = contents(snapshot);
+        snapshot.clear();
+    }};
+    for(int key{0}; key < 10000; key += 2)
+    {
+        tree.remove(key);
+    }
+    exporter.join();
+    EXPECT_EQ(exported.size(), 10000);
+    EXPECT_EQ(contents(tree).size(), 5000);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+#define ALGO_RED_BLACK_TREE_STATS
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include "../source/red_black_tree.h"
+
+TEST(red_black_tree_stats_test, counts_events)
+{
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 1000; ++key)
+    {
+        tree.insert(key, key);
+    }
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::allocation), 1000);
+    EXPECT_GT(tree.event_count(algo::RedBlackEvent::rotation), 0);
+    EXPECT_GT(tree.event_count(algo::RedBlackEvent::insert_fixup_case1), 0);
+    EXPECT_GT(tree.event_count(algo::RedBlackEvent::insert_fixup_case3), 0);
+    tree.reset_event_counts();
+    EXPECT_NE(tree.find(500), nullptr);
+    std::uint64_t comparisons{tree.event_count(algo::RedBlackEvent::comparison)};
+    EXPECT_GT(comparisons, 0);
+    EXPECT_LE(comparisons, 2 * tree.shape().height);
+    for(int key{0}; key < 1000; key += 2)
+    {
+        tree.remove(key);
+    }
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::deallocation), 500);
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::allocation), 0);
+}
+
+TEST(red_black_tree_stats_test, dropped_node_handle_counts_deallocation)
+{
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 10; ++key)
+    {
+        tree.insert(key, key);
+    }
+    tree.insert(tree.extract(1));
+    {
+        auto dropped{tree.extract(3)};
+    }
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::allocation), 10);
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::deallocation), 1);
+    tree.clear();
+    EXPECT_EQ(tree.event_count(algo::RedBlackEvent::deallocation), 10);
+
+    decltype(tree.extract(0)) outlived;
+    {
+        algo::RedBlackTree<int, int> scratch;
+        scratch.insert(1, 1);
+        outlived = scratch.extract(1);
+    }
+    EXPECT_EQ(outlived.key(), 1);
+}
+
+TEST(red_black_tree_stats_test, shape_and_validate)
+{
+    std::mt19937 engine{31};
+    algo::RedBlackTree<int, int> tree;
+    for(int step{0}; step < 20000; ++step)
+    {
+        int key{static_cast<int>(engine() % 4000)};
+        if(engine() % 3 == 0)
+        {
+            tree.remove(key);
+        }
+        else
+        {
+            tree.insert(key, key);
+        }
+        if(step % 1000 == 0)
+        {
+            ASSERT_NO_THROW(tree.validate());
+        }
+    }
+    ASSERT_NO_THROW(tree.validate());
+    auto shape{tree.shape()};
+    std::size_t counted{0};
+    tree.for_each([&](int, int)
+    {
+        ++counted;
+    });
+    EXPECT_EQ(shape.size, counted);
+    EXPECT_EQ(std::accumulate(shape.depthHistogram.begin(), shape.depthHistogram.end(), std::size_t{0}), counted);
+    EXPECT_EQ(shape.depthHistogram.front(), 1);
+    EXPECT_LE(shape.height, 2 * std::bit_width(counted + 1));
+    EXPECT_GE(shape.height, shape.blackHeight);
+    tree.find(0)->set_color(algo::RedBlackColor::red);
+    tree.find(1)->set_color(algo::RedBlackColor::red);
+    EXPECT_THROW(tree.validate(), std::logic_error);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,13 @@
-//#include <gtest/gtest.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <numeric>
 #include <vector>
 #include <random>
+#include <string>
+#include <string_view>
+#include <thread>
 #include "../source/red_black_tree.h"
 
 /*TEST(red_black_tree_test_insert, insert)
@@ -54,7 +61,7 @@ TEST(red_black_tree_test_remove, remove)
     
 }*/
 
-int main(int argc, char** argv)
+TEST(red_black_tree_test, insert_remove_shuffled)
 {
     std::vector<int> keys{10, 85, 15, 70, 20, 60, 30, 50, 65, 80, 90, 40, 5, 55};
     algo::RedBlackTree<int, int> tree;
@@ -67,11 +74,373 @@ int main(int argc, char** argv)
     {
         tree.remove(key);
     }
+    EXPECT_TRUE(tree.empty());
     for(const auto& key : keys)
     {
         tree.insert(key, 0);
     }
-    std::cout << "Success\n";
-    //testing::InitGoogleTest(&argc, argv);
-    return 0;//RUN_ALL_TESTS();
-}
\ No newline at end of file
+    for(const auto& key : keys)
+    {
+        EXPECT_NE(tree.find(key), nullptr);
+    }
+}
+
+TEST(red_black_tree_test, split_join)
+{
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 1000; ++key)
+    {
+        tree.insert(key, key);
+    }
+    auto upper{tree.split(600)};
+    EXPECT_EQ(tree.find(600), nullptr);
+    EXPECT_NE(tree.find(599), nullptr);
+    EXPECT_NE(upper.find(600), nullptr);
+    EXPECT_EQ(upper.find(599), nullptr);
+    upper.remove(600);
+    tree.join(600, -1, std::move(upper));
+    EXPECT_TRUE(upper.empty());
+    EXPECT_EQ(tree.find(600)->data, -1);
+    auto rest{tree.split(100)};
+    tree.join2(std::move(rest));
+    for(int key{0}; key < 1000; ++key)
+    {
+        ASSERT_NE(tree.find(key), nullptr);
+    }
+}
+
+TEST(red_black_tree_test, set_operations)
+{
+    std::mt19937 engine{42};
+    std::vector<int> lhsKeys(20000);
+    std::vector<int> rhsKeys(5000);
+    std::ranges::generate(lhsKeys, [&]{ return static_cast<int>(engine() % 40000); });
+    std::ranges::generate(rhsKeys, [&]{ return static_cast<int>(engine() % 40000); });
+    algo::RedBlackTree<int, int> lhs;
+    algo::RedBlackTree<int, int> rhs;
+    for(const auto& key : lhsKeys)
+    {
+        lhs.insert(key, 1);
+    }
+    for(const auto& key : rhsKeys)
+    {
+        rhs.insert(key, 2);
+    }
+    auto united{lhs};
+    united.set_union(algo::RedBlackTree<int, int>{rhs});
+    auto intersected{lhs};
+    intersected.set_intersection(algo::RedBlackTree<int, int>{rhs});
+    auto subtracted{lhs};
+    subtracted.set_difference(algo::RedBlackTree<int, int>{rhs});
+    for(int key{0}; key < 40000; ++key)
+    {
+        bool inLhs{lhs.find(key) != nullptr};
+        bool inRhs{rhs.find(key) != nullptr};
+        ASSERT_EQ(united.find(key) != nullptr, inLhs || inRhs);
+        ASSERT_EQ(intersected.find(key) != nullptr, inLhs && inRhs);
+        ASSERT_EQ(subtracted.find(key) != nullptr, inLhs && !inRhs);
+        if(inLhs)
+        {
+            ASSERT_EQ(united.find(key)->data, 1);
+        }
+    }
+}
+
+namespace
+{
+    // Notes whether any comparison ran off the main thread, i.e. whether a set
+    // operation actually forked.
+    struct ForkDetectingLess
+    {
+        bool operator()(int lhs, int rhs) const
+        {
+            if(std::this_thread::get_id() != mainThread)
+            {
+                forked.store(true, std::memory_order_relaxed);
+            }
+            return lhs < rhs;
+        }
+
+        static inline std::thread::id mainThread{};
+        static inline std::atomic<bool> forked{false};
+    };
+
+    template<typename Operation>
+    std::vector<int> expected_keys(const std::vector<int>& lhs, const std::vector<int>& rhs, Operation operation)
+    {
+        std::vector<int> result;
+        operation(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+        return result;
+    }
+}
+
+// Large enough that the pivot subtrees reach the black height at which the set
+// operations hand half of the recursion to another thread.
+TEST(red_black_tree_test, parallel_set_operations)
+{
+    using Tree = algo::RedBlackTree<int, int, ForkDetectingLess>;
+    std::mt19937 engine{7};
+    const auto random_keys{[&](std::size_t count)
+    {
+        std::vector<int> keys(count);
+        std::ranges::generate(keys, [&]{ return static_cast<int>(engine() % 2000000); });
+        std::ranges::sort(keys);
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }};
+    const auto lhsKeys{random_keys(400000)};
+    const auto rhsKeys{random_keys(300000)};
+    Tree lhs;
+    Tree rhs;
+    for(const auto& key : lhsKeys)
+    {
+        lhs.insert(key, key);
+    }
+    for(const auto& key : rhsKeys)
+    {
+        rhs.insert(key, key);
+    }
+    ASSERT_GE(lhs.shape().blackHeight, 10u);
+    ASSERT_GE(rhs.shape().blackHeight, 10u);
+    const auto keys_of{[](const Tree& tree)
+    {
+        std::vector<int> keys;
+        tree.for_each([&](int key, int){ keys.push_back(key); });
+        return keys;
+    }};
+
+    ForkDetectingLess::mainThread = std::this_thread::get_id();
+    ForkDetectingLess::forked = false;
+    auto united{lhs};
+    united.set_union(Tree{rhs});
+    EXPECT_TRUE(ForkDetectingLess::forked);
+    EXPECT_EQ(keys_of(united), expected_keys(lhsKeys, rhsKeys, [](auto... args){ return std::set_union(args...); }));
+    united.validate();
+
+    ForkDetectingLess::forked = false;
+    auto intersected{lhs};
+    intersected.set_intersection(Tree{rhs});
+    EXPECT_TRUE(ForkDetectingLess::forked);
+    EXPECT_EQ(keys_of(intersected), expected_keys(lhsKeys, rhsKeys, [](auto... args){ return std::set_intersection(args...); }));
+    intersected.validate();
+
+    ForkDetectingLess::forked = false;
+    auto subtracted{lhs};
+    subtracted.set_difference(Tree{rhs});
+    EXPECT_TRUE(ForkDetectingLess::forked);
+    EXPECT_EQ(keys_of(subtracted), expected_keys(lhsKeys, rhsKeys, [](auto... args){ return std::set_difference(args...); }));
+    subtracted.validate();
+}
+
+TEST(red_black_tree_test, compact_nodes)
+{
+    EXPECT_LT(sizeof(algo::PackedRedBlackNode<int, int>), sizeof(algo::RedBlackNode<int, int>));
+    std::vector<int> keys(2000);
+    std::iota(std::begin(keys), std::end(keys), 0);
+    std::shuffle(std::begin(keys), std::end(keys), std::default_random_engine{});
+    algo::CompactRedBlackTree<int, int> tree;
+    for(const auto& key : keys)
+    {
+        tree.insert(key, key);
+    }
+    for(int key{0}; key < 2000; key += 2)
+    {
+        tree.remove(key);
+    }
+    for(int key{0}; key < 2000; ++key)
+    {
+        ASSERT_EQ(tree.find(key) != nullptr, key % 2 == 1);
+    }
+}
+
+TEST(red_black_tree_test, emplace_returns_inserted_node)
+{
+    std::mt19937 engine{17};
+    algo::RedBlackTree<int, int> tree;
+    for(int step{0}; step < 5000; ++step)
+    {
+        int key{static_cast<int>(engine() % 2000)};
+        tree[key] = key + 1;
+        ASSERT_EQ(tree.find(key)->data, key + 1);
+    }
+}
+
+TEST(red_black_tree_test, find_batch)
+{
+    std::mt19937 engine{23};
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 3000; key += 3)
+    {
+        tree.insert(key, key);
+    }
+    std::vector<int> keys(1000);
+    std::generate(keys.begin(), keys.end(), [&]{ return static_cast<int>(engine() % 3100); });
+    std::vector<algo::RedBlackTree<int, int>::iterator> found(keys.size());
+    tree.find_batch(keys, found);
+    for(std::size_t index{0}; index < keys.size(); ++index)
+    {
+        EXPECT_EQ(found[index], tree.find(keys[index]));
+    }
+    EXPECT_THROW(tree.find_batch(keys, std::span{found}.first(10)), std::length_error);
+}
+
+TEST(red_black_tree_test, extract_and_insert_node)
+{
+    algo::RedBlackTree<int, int> source;
+    algo::RedBlackTree<int, int> target;
+    for(int key{0}; key < 100; ++key)
+    {
+        source.insert(key, key * 10);
+    }
+    auto handle{source.extract(42)};
+    ASSERT_FALSE(handle.empty());
+    EXPECT_EQ(handle.key(), 42);
+    EXPECT_EQ(source.find(42), nullptr);
+    EXPECT_TRUE(source.extract(42).empty());
+    auto* node{&handle.mapped()};
+    auto inserted{target.insert(std::move(handle))};
+    EXPECT_TRUE(handle.empty());
+    EXPECT_EQ(&inserted->data, node);
+    EXPECT_EQ(target.find(42)->data, 420);
+    target.insert(7, 0);
+    auto duplicate{source.extract(7)};
+    EXPECT_EQ(target.insert(std::move(duplicate))->data, 0);
+    EXPECT_FALSE(duplicate.empty());
+}
+
+TEST(red_black_tree_test, merge_keeps_duplicates_in_source)
+{
+    algo::RedBlackTree<int, int> tree;
+    algo::RedBlackTree<int, int> other;
+    for(int key{0}; key < 1000; key += 2)
+    {
+        tree.insert(key, 0);
+    }
+    for(int key{0}; key < 2000; key += 3)
+    {
+        other.insert(key, 1);
+    }
+    tree.merge(other);
+    int merged{0};
+    tree.for_each([&](int key, int value)
+    {
+        EXPECT_EQ(value, key % 2 == 0 && key < 1000? 0 : 1);
+        ++merged;
+    });
+    EXPECT_EQ(merged, 500 + 667 - 167);
+    other.for_each([&](int key, int value)
+    {
+        EXPECT_TRUE(key % 2 == 0 && key < 1000);
+        EXPECT_EQ(value, 1);
+    });
+    tree.remove(1998);
+    EXPECT_EQ(tree.emplace_hint(nullptr, 5000, 5)->data, 5);
+}
+
+TEST(red_black_tree_test, emplace_hint)
+{
+    algo::RedBlackTree<int, int> tree;
+    for(int key{0}; key < 10000; ++key)
+    {
+        tree.emplace_hint(nullptr, key, key);
+    }
+    auto hint{tree.find(5000)};
+    for(int key{-100}; key < 10100; key += 7)
+    {
+        EXPECT_EQ(tree.emplace_hint(hint, key, -1)->key, key);
+    }
+    std::vector<int> keys;
+    tree.for_each([&](int key, int)
+    {
+        keys.push_back(key);
+    });
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    EXPECT_EQ(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+    EXPECT_EQ(tree.find(3)->data, 3);
+    EXPECT_EQ(tree.find(10099)->data, -1);
+}
+
+namespace
+{
+    struct CountedKey
+    {
+        explicit CountedKey(std::string_view text)
+            : text{text}
+        {
+            ++constructions;
+        }
+
+        CountedKey(const CountedKey& that)
+            : text{that.text}
+        {
+            ++constructions;
+        }
+
+        CountedKey(CountedKey&& that) noexcept = default;
+
+        std::string text;
+        static inline int constructions{0};
+    };
+
+    struct CountedKeyLess
+    {
+        using is_transparent = void;
+
+        static std::string_view view(const CountedKey& key)
+        {
+            return key.text;
+        }
+
+        static std::string_view view(std::string_view text)
+        {
+            return text;
+        }
+
+        template<typename Left, typename Right>
+        bool operator()(const Left& left, const Right& right) const
+        {
+            return view(left) < view(right);
+        }
+    };
+}
+
+TEST(red_black_tree_test, transparent_lookup)
+{
+    algo::RedBlackTree<CountedKey, int, CountedKeyLess> tree;
+    for(std::string_view text : {"delta", "alpha", "echo", "charlie", "bravo"})
+    {
+        tree.try_emplace(text, static_cast<int>(text.size()));
+    }
+    EXPECT_EQ(CountedKey::constructions, 5);
+    EXPECT_EQ(tree.try_emplace(std::string_view{"alpha"}, 0)->data, 5);
+    EXPECT_EQ(tree.find(std::string_view{"charlie"})->data, 7);
+    EXPECT_TRUE(tree.contains(std::string_view{"echo"}));
+    EXPECT_FALSE(tree.contains(std::string_view{"foxtrot"}));
+    EXPECT_EQ(tree.lower_bound(std::string_view{"c"})->key.text, "charlie");
+    EXPECT_EQ(tree.upper_bound(std::string_view{"charlie"})->key.text, "delta");
+    EXPECT_EQ(tree.upper_bound(std::string_view{"echo"}), nullptr);
+    tree.remove(std::string_view{"bravo"});
+    EXPECT_EQ(tree.extract(std::string_view{"delta"}).mapped(), 5);
+    EXPECT_EQ(CountedKey::constructions, 5);
+    EXPECT_FALSE(tree.contains(std::string_view{"bravo"}));
+}
+
+TEST(red_black_tree_test, try_emplace_keeps_existing_value)
+{
+    algo::RedBlackTree<std::string, std::string, std::less<>> tree;
+    tree.try_emplace("key", "first");
+    std::string key{"key"};
+    std::string value{"second"};
+    tree.try_emplace(std::move(key), std::move(value));
+    EXPECT_EQ(tree.find("key")->data, "first");
+    EXPECT_EQ(key, "key");
+    EXPECT_EQ(value, "second");
+    tree["other"] += "value";
+    EXPECT_EQ(tree.find(std::string_view{"other"})->data, "value");
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,28 @@
+#ifndef SCRATCH_DIRECTORY_FIXTURE_H
+#define SCRATCH_DIRECTORY_FIXTURE_H
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "../source/scratch_directory.h"
+
+namespace algo
+{
+    // Gives every test its own empty directory, named after the test suite, under the
+    // system temporary directory, and removes it after the test whatever it left there.
+    class ScratchDirectoryTest : public testing::Test
+    {
+    protected:
+        ScratchDirectoryTest()
+            : scratch{std::filesystem::temp_directory_path(),
+                      std::string{testing::UnitTest::GetInstance()->current_test_info()->test_suite_name()} + "_"}
+            , directory{scratch.path()}
+        {
+        }
+
+        ScratchDirectory scratch;
+        std::filesystem::path directory;
+    };
+}
+
+#endif